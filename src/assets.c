@@ -0,0 +1,229 @@
+#include "assets.h"
+#include "loader.h"
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+// Kinds of cached assets
+typedef enum {
+    ASSET_FREE = 0,
+    ASSET_TEXTURE,
+    ASSET_SOUND
+} AssetType;
+
+// Cache entry, stored in an open-addressing table keyed by file name
+typedef struct {
+    AssetType type;
+    bool deleted;            // Tombstone left by an unloaded asset (keeps probe chains intact)
+    unsigned int hash;       // Hash of fileName
+    char fileName[64];
+    int refCount;            // References held by all scopes
+    TextureAsset texture;    // GPU texture and CPU pixels
+    Sound sound;
+} CachedAsset;
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static CachedAsset cache[MAX_CACHED_ASSETS];
+static int cachedCount = 0;
+static int lastImageIndex = -1;              // Entry found by the last GetTextureImage call
+static Texture2D missingTexture = { 0 };     // Returned when the cache is full
+static Sound missingSound = { 0 };
+static pthread_t cacheThread;                // Thread that made the first call (see CheckCacheThread)
+static bool cacheThreadSet = false;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// FNV-1a hash of a file name
+static unsigned int HashFileName(const char *fileName) {
+    unsigned int hash = 2166136261u;
+
+    for (const unsigned char *c = (const unsigned char *)fileName; *c != '\0'; c++) {
+        hash = (hash ^ *c) * 16777619u;
+    }
+
+    return hash;
+}
+
+// Find the entry of a file name, returns -1 if it isn't cached
+static int FindEntry(const char *fileName, unsigned int hash) {
+    for (int probe = 0; probe < MAX_CACHED_ASSETS; probe++) {
+        int index = (hash + probe) % MAX_CACHED_ASSETS;
+
+        if (cache[index].type == ASSET_FREE) {
+            if (!cache[index].deleted) return -1;
+            continue;
+        }
+
+        if (cache[index].hash == hash && strcmp(cache[index].fileName, fileName) == 0) return index;
+    }
+
+    return -1;
+}
+
+// Insert a new entry, returns -1 if the cache is full
+static int InsertEntry(const char *fileName, unsigned int hash, AssetType type) {
+    for (int probe = 0; probe < MAX_CACHED_ASSETS; probe++) {
+        int index = (hash + probe) % MAX_CACHED_ASSETS;
+
+        if (cache[index].type == ASSET_FREE) {
+            memset(&cache[index], 0, sizeof(CachedAsset));
+            cache[index].type = type;
+            cache[index].hash = hash;
+            snprintf(cache[index].fileName, sizeof(cache[index].fileName), "%s", fileName);
+            cachedCount++;
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+// Unload the asset of an entry and leave a tombstone
+static void UnloadEntry(int index) {
+    if (cache[index].type == ASSET_TEXTURE) {
+        if (cache[index].texture.texture.id != 0) UnloadTexture(cache[index].texture.texture);
+        if (cache[index].texture.ownsImage) UnloadImage(cache[index].texture.image);
+    } else if (cache[index].type == ASSET_SOUND && cache[index].sound.frameCount != 0) {
+        UnloadSound(cache[index].sound);
+    }
+
+    cache[index].type = ASSET_FREE;
+    cache[index].deleted = true;
+    cachedCount--;
+
+    if (lastImageIndex == index) lastImageIndex = -1;
+}
+
+// The cache isn't thread-safe: every call must come from the thread that made the first one
+// (the main thread, the simulation thread of the pipelined mode never acquires or releases)
+static void CheckCacheThread(void) {
+    if (!cacheThreadSet) {
+        cacheThread = pthread_self();
+        cacheThreadSet = true;
+    }
+    assert(pthread_equal(cacheThread, pthread_self()));
+}
+
+// Find or create the entry of a file name and add a reference held by the scope
+// Sets *isNew when the asset still has to be loaded
+static int AcquireEntry(AssetScope *scope, AssetType type, const char *fileName, bool *isNew) {
+    CheckCacheThread();
+    *isNew = false;
+
+    if (scope->count >= MAX_SCOPE_ASSETS) {
+        printf("Error: asset scope full, can't reference %s\n", fileName);
+        return -1;
+    }
+
+    unsigned int hash = HashFileName(fileName);
+    int index = FindEntry(fileName, hash);
+
+    if (index < 0) {
+        index = InsertEntry(fileName, hash, type);
+        if (index < 0) {
+            printf("Error: asset cache full, can't load %s\n", fileName);
+            return -1;
+        }
+        *isNew = true;
+    }
+
+    cache[index].refCount++;
+    scope->entries[scope->count++] = index;
+
+    return index;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Get a cached texture
+Texture2D *AcquireTexture(AssetScope *scope, const char *fileName, const char *fallbackFileName) {
+    bool isNew;
+    int index = AcquireEntry(scope, ASSET_TEXTURE, fileName, &isNew);
+    if (index < 0) return &missingTexture;
+
+    // Load in the background while the loader is accepting requests, right away otherwise
+    if (isNew && !QueueTextureLoad(fileName, fallbackFileName, &cache[index].texture)) {
+        cache[index].texture = LoadTextureAsset(fileName, fallbackFileName);
+    }
+
+    return &cache[index].texture.texture;
+}
+
+// Get a cached sound
+Sound *AcquireSound(AssetScope *scope, const char *fileName) {
+    bool isNew;
+    int index = AcquireEntry(scope, ASSET_SOUND, fileName, &isNew);
+    if (index < 0) return &missingSound;
+
+    if (isNew && !QueueSoundLoad(fileName, &cache[index].sound)) {
+        cache[index].sound = LoadSoundAsset(fileName);
+    }
+
+    return &cache[index].sound;
+}
+
+// Drop every reference held by a scope
+void ReleaseAssetScope(AssetScope *scope) {
+    CheckCacheThread();
+
+    for (int i = 0; i < scope->count; i++) {
+        int index = scope->entries[i];
+
+        if (cache[index].type == ASSET_FREE || cache[index].refCount <= 0) continue;
+
+        cache[index].refCount--;
+
+        // Assets still waiting for the loader stay cached until UnloadAssetCache
+        if (cache[index].refCount == 0 && IsAssetLoadComplete()) {
+            UnloadEntry(index);
+        }
+    }
+
+    scope->count = 0;
+}
+
+// Unload every cached asset
+void UnloadAssetCache(void) {
+    CheckCacheThread();
+
+    for (int i = 0; i < MAX_CACHED_ASSETS; i++) {
+        if (cache[i].type != ASSET_FREE) UnloadEntry(i);
+        cache[i].deleted = false;
+    }
+
+    cachedCount = 0;
+    lastImageIndex = -1;
+}
+
+// Number of assets currently in the cache
+int GetCachedAssetCount(void) {
+    return cachedCount;
+}
+
+// Get the CPU copy of a cached texture
+const Image *GetTextureImage(Texture2D texture) {
+    CheckCacheThread();
+    if (texture.id == 0) return NULL;
+
+    // Pixel queries usually come in runs on the same texture
+    if (lastImageIndex >= 0 && cache[lastImageIndex].texture.texture.id == texture.id) {
+        return &cache[lastImageIndex].texture.image;
+    }
+
+    for (int i = 0; i < MAX_CACHED_ASSETS; i++) {
+        if (cache[i].type == ASSET_TEXTURE && cache[i].texture.texture.id == texture.id &&
+            cache[i].texture.image.data != NULL) {
+            lastImageIndex = i;
+            return &cache[i].texture.image;
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,38 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+
+// The asset cache isn't thread-safe: every function must be called from the main thread
+// (checked with assert, the loader thread only decodes into the entries it is handed)
+
+// Asset cache configuration
+#define MAX_CACHED_ASSETS   128      // Maximum number of distinct assets alive at once
+#define MAX_SCOPE_ASSETS    96       // Maximum number of references held by one scope
+
+// Lifetime scope: every asset acquired through a scope is referenced until the scope is released
+// (the game keeps one global scope and one per-level scope)
+typedef struct {
+    int entries[MAX_SCOPE_ASSETS];   // Cache entries referenced by this scope
+    int count;                       // Number of references
+} AssetScope;
+
+// Get a cached texture (loading it on the first request) and add a reference to the scope
+Texture2D *AcquireTexture(AssetScope *scope, const char *fileName, const char *fallbackFileName);
+
+// Get a cached sound (loading it on the first request) and add a reference to the scope
+Sound *AcquireSound(AssetScope *scope, const char *fileName);
+
+// Drop every reference held by a scope, assets without references are unloaded
+void ReleaseAssetScope(AssetScope *scope);
+
+// Unload every cached asset, whatever its reference count
+void UnloadAssetCache(void);
+
+// Number of assets currently in the cache
+int GetCachedAssetCount(void);
+
+// Get the CPU copy (RGBA8) of a cached texture, returns NULL if the texture isn't cached
+const Image *GetTextureImage(Texture2D texture);
+
+#endif // ASSETS_H
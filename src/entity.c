@@ -0,0 +1,116 @@
+#include "entity.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Dense array and element size of a component type
+static unsigned char *ComponentArray(EntityStore *store, ComponentType type, size_t *size) {
+    switch (type) {
+        case COMPONENT_TRANSFORM: *size = sizeof(TransformComponent); return (unsigned char *)store->transforms;
+        case COMPONENT_RENDER:    *size = sizeof(RenderComponent);    return (unsigned char *)store->renders;
+        case COMPONENT_ANIMATION: *size = sizeof(Animation);          return (unsigned char *)store->animations;
+        case COMPONENT_HEALTH:    *size = sizeof(HealthComponent);    return (unsigned char *)store->healths;
+        case COMPONENT_AI:        *size = sizeof(AIComponent);        return (unsigned char *)store->ais;
+        default:                  *size = 0;                          return NULL;
+    }
+}
+
+// Remove a component from a slot, moving the last dense entry into its place
+static void RemoveComponent(EntityStore *store, int slot, ComponentType type) {
+    size_t size;
+    unsigned char *array = ComponentArray(store, type, &size);
+
+    int hole = store->dense[type][slot];
+    int last = --store->count[type];
+
+    if (hole != last) {
+        int movedSlot = store->owner[type][last];
+        memcpy(array + hole * size, array + last * size, size);
+        store->owner[type][hole] = (unsigned char)movedSlot;
+        store->dense[type][movedSlot] = (unsigned char)hole;
+    }
+
+    store->mask[slot] &= ~(1u << type);
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Destroy every entity
+void ClearEntities(EntityStore *store) {
+    for (int i = 0; i < MAX_ENTITIES; i++) {
+        if (store->alive[i]) DestroyEntity(store, (EntityHandle){ (unsigned short)i, store->generation[i] });
+    }
+}
+
+// Create an entity in the first free slot
+EntityHandle CreateEntity(EntityStore *store) {
+    for (int i = 0; i < MAX_ENTITIES; i++) {
+        if (store->alive[i]) continue;
+
+        // Generation 0 is reserved for NULL_ENTITY
+        if (store->generation[i] == 0) store->generation[i] = 1;
+
+        store->alive[i] = true;
+        store->mask[i] = 0;
+        return (EntityHandle){ (unsigned short)i, store->generation[i] };
+    }
+
+    return NULL_ENTITY;
+}
+
+// Destroy an entity and its components
+void DestroyEntity(EntityStore *store, EntityHandle entity) {
+    if (!IsEntityAlive(store, entity)) return;
+
+    for (int type = 0; type < COMPONENT_COUNT; type++) {
+        if (store->mask[entity.index] & (1u << type)) RemoveComponent(store, entity.index, (ComponentType)type);
+    }
+
+    store->alive[entity.index] = false;
+
+    // A new generation invalidates the handles still around
+    store->generation[entity.index]++;
+    if (store->generation[entity.index] == 0) store->generation[entity.index] = 1;
+}
+
+// Check if a handle refers to a live entity
+bool IsEntityAlive(const EntityStore *store, EntityHandle entity) {
+    return (entity.generation != 0) && (entity.index < MAX_ENTITIES) && store->alive[entity.index] &&
+           (store->generation[entity.index] == entity.generation);
+}
+
+// Add a component to an entity
+void *AddComponent(EntityStore *store, EntityHandle entity, ComponentType type) {
+    if (!IsEntityAlive(store, entity)) return NULL;
+    if (store->mask[entity.index] & (1u << type)) return GetComponent(store, entity, type);
+
+    size_t size;
+    unsigned char *array = ComponentArray(store, type, &size);
+    int i = store->count[type]++;
+
+    store->owner[type][i] = (unsigned char)entity.index;
+    store->dense[type][entity.index] = (unsigned char)i;
+    store->mask[entity.index] |= 1u << type;
+
+    memset(array + i * size, 0, size);
+    return array + i * size;
+}
+
+// Component of an entity
+void *GetComponent(EntityStore *store, EntityHandle entity, ComponentType type) {
+    if (!IsEntityAlive(store, entity) || !(store->mask[entity.index] & (1u << type))) return NULL;
+
+    size_t size;
+    unsigned char *array = ComponentArray(store, type, &size);
+    return array + store->dense[type][entity.index] * size;
+}
+
+// Entity owning a dense component entry
+EntityHandle GetComponentOwner(const EntityStore *store, ComponentType type, int i) {
+    int slot = store->owner[type][i];
+    return (EntityHandle){ (unsigned short)slot, store->generation[slot] };
+}
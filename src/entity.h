@@ -0,0 +1,103 @@
+#ifndef ENTITY_H
+#define ENTITY_H
+
+#include "raylib.h"
+#include "maze.h"
+
+#define MAX_ENTITIES    16       // Entities alive at once (keys, exit door and enemies)
+
+// Reference to an entity. A destroyed entity's slot gets a new generation, so old handles
+// stop matching instead of pointing at whatever reuses the slot
+typedef struct {
+    unsigned short index;       // Slot in the store
+    unsigned short generation;  // Generation of the slot when the entity was created (0 = no entity)
+} EntityHandle;
+
+#define NULL_ENTITY     ((EntityHandle){ 0, 0 })
+
+// Component types
+typedef enum {
+    COMPONENT_TRANSFORM,
+    COMPONENT_RENDER,
+    COMPONENT_ANIMATION,
+    COMPONENT_HEALTH,
+    COMPONENT_AI,
+    COMPONENT_COUNT
+} ComponentType;
+
+// Place in the world
+typedef struct {
+    Vector2 position;       // Position (x, y) on the map
+    Vector2 prevPosition;   // Position at the previous simulation step (for interpolation)
+    float angle;            // Facing angle in radians
+} TransformComponent;
+
+// Billboard drawn by the renderer
+typedef struct {
+    Texture2D *texture;     // Current texture, drawn whole (owned by the asset cache)
+    CellType type;          // Key, exit door or enemy
+} RenderComponent;
+
+// Animation structure
+typedef struct {
+    int currentAnim;     // Current animation (0=idle, 1=walk, 2=attack, 3=pain, 4=death)
+    int currentFrame;    // Current animation frame
+    float frameTimer;    // Timer for frame change
+    bool isPlaying;      // If the animation is playing
+    bool loop;           // If the animation should loop
+} Animation;
+
+// Hit points
+typedef struct {
+    int health;
+    bool isDying;           // Playing its death animation, destroyed when it ends
+} HealthComponent;
+
+// Enemy behaviour
+typedef struct {
+    float attackCooldown;   // Cooldown time between attacks
+    float moveTimer;        // Timer for direction change
+    Vector2 direction;      // Current movement direction
+} AIComponent;
+
+// Entities and their components. Every component type is stored densely, without holes, so a
+// system loops over exactly the components it uses: entry i of a type belongs to the entity
+// in slot owner[type][i] (see GetComponentOwner)
+typedef struct {
+    bool alive[MAX_ENTITIES];
+    unsigned short generation[MAX_ENTITIES];
+    unsigned int mask[MAX_ENTITIES];                        // Components of each slot (1 << ComponentType)
+    int count[COMPONENT_COUNT];                             // Components of each type
+    unsigned char owner[COMPONENT_COUNT][MAX_ENTITIES];     // Slot owning each dense entry
+    unsigned char dense[COMPONENT_COUNT][MAX_ENTITIES];     // Dense entry of each slot
+
+    TransformComponent transforms[MAX_ENTITIES];
+    RenderComponent renders[MAX_ENTITIES];
+    Animation animations[MAX_ENTITIES];
+    HealthComponent healths[MAX_ENTITIES];
+    AIComponent ais[MAX_ENTITIES];
+} EntityStore;
+
+// Destroy every entity (their handles become invalid)
+void ClearEntities(EntityStore *store);
+
+// Create an entity without components, returns NULL_ENTITY if the store is full
+EntityHandle CreateEntity(EntityStore *store);
+
+// Destroy an entity and its components (the dense arrays are compacted: the last entry of
+// each type moves into the hole, so loops that destroy entities must run backwards)
+void DestroyEntity(EntityStore *store, EntityHandle entity);
+
+// Check if a handle still refers to a live entity
+bool IsEntityAlive(const EntityStore *store, EntityHandle entity);
+
+// Add a component (zero-initialized) or return the existing one, NULL for dead entities
+void *AddComponent(EntityStore *store, EntityHandle entity, ComponentType type);
+
+// Component of an entity, NULL if it doesn't have one
+void *GetComponent(EntityStore *store, EntityHandle entity, ComponentType type);
+
+// Entity owning entry i of a dense component array
+EntityHandle GetComponentOwner(const EntityStore *store, ComponentType type, int i);
+
+#endif // ENTITY_H
@@ -1,6 +1,18 @@
 #include "game.h"
 #include "utils.h"
+#include "pack.h"
+#include "loader.h"
+#include "assets.h"
+#include "levelpool.h"
+#include "profiler.h"
+#include "trace.h"
+#include "raycast.h"
+#include "triplebuffer.h"
+#include "rendercache.h"
+#include "shade.h"
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -10,34 +22,99 @@
 // ----------------------------------------------------------------------------------
 static GameState currentState;        // Current game state
 static Player player;                 // Player data
-static Enemy enemies[MAX_ENEMIES];    // Array of enemies
 static Maze gameMaze;                 // Maze structure
-static int enemyCount;                // Current number of enemies
-static Sprite sprites[MAX_SPRITES];   // Array of sprites (keys, enemies, etc.)
-static int spriteCount;               // Current number of sprites
+static Level *currentLevel = NULL;    // Level being played (owned by the level pool)
+static EntityStore entities;          // Keys, exit door and enemies
+static ExitDoor exitDoor;             // Exit door of the level
+static Crosshair crosshair;           // Crosshair layout (set once)
+static int spriteOrder[MAX_SPRITES];  // Sprite drawing order (farthest first), kept between frames
+static int spriteOrderCount = 0;      // Number of sprites spriteOrder was built for
 static bool showExitMessage = false;  // Show victory message
 static float exitMessageTimer = 0.0f; // Timer for victory message
 static WeaponAnimation katanaAnim;
+static float simAccumulator = 0.0f;   // Frame time not simulated yet
+static unsigned int pendingPressed;   // Pressed actions waiting for the next simulation step
+static float renderAlpha = 1.0f;      // Interpolation factor between the last two simulation steps
+static RayCamera viewCamera;         // Interpolated player camera, built once per frame for rendering
+static GameInputSource inputSource = NULL; // Custom input source (NULL = keyboard)
+static bool headlessMode = false;     // No window, GPU or audio
+static unsigned int gameSeed = 0;     // Seed requested with SetGameSeed (0 = time based)
+static unsigned int gameTicks = 0;    // Simulation steps run so far
 
-// Textures
-static Texture2D wallTextures[1];     // Wall texture (only one to save space)
-static Texture2D weaponTexture;       // Player's weapon texture
-static Texture2D keyTexture;          // Key texture
-static Texture2D impTextures[56];     // Array of individual enemy textures
+// World snapshots: the simulation publishes one after its steps, the renderer draws the latest
+static WorldSnapshot snapshots[3];
+static TripleBuffer snapshotBuffer;
 
-// Sounds
-static Sound footstepSound;
-static Sound victorySound;
-static Sound keyPickupSound;
-static Sound playerHitSound;          // Sound when player takes damage
-static Sound gameOverSound;           // Game over sound
-static Sound shootSound;
+// Pipelined mode: the simulation thread consumes the input of each frame from a small queue
+static bool pipelinedMode = false;
+static pthread_t simThread;
+static bool simRunning = false;
+static bool simStopRequested = false;
+static GameInput inputQueue[PIPELINE_INPUT_FRAMES];
+static int inputHead = 0;
+static int inputCount = 0;
+static pthread_mutex_t inputMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t inputReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t inputFree = PTHREAD_COND_INITIALIZER;
+
+// Sounds triggered by the simulation (GameSound bits), played on the main thread
+static atomic_uint queuedSounds;
+
+// Cached render targets (see rendercache.h): screens that don't change are drawn once and blitted
+static CachedLayer screenLayer;       // Title, victory or game over screen (key = state)
+static CachedLayer promptLayer;       // Blinking instruction of that screen (key = state)
+static CachedLayer pausedLayer;       // Frame shown under the pause screen
+static CachedLayer pauseTextLayer;    // Pause screen text
+static CachedLayer exitMessageLayer;  // HUD message of the locked exit (key = keys missing)
+static GameState lastRenderedState = GAME_TITLE;
+
+// Scratch memory for the temporaries of the frame being rendered (render thread only)
+static Arena frameArena;
+
+// Per-column results of the wall traversal pass, kept between frames (render thread only)
+static ColumnBuffer columns;
+
+// Fog and light shade levels of the 3D view
+static ShadeTable shadeTable;
+
+// Textures (owned by the asset cache)
+static Texture2D *wallTextures[1];    // Wall texture (only one to save space)
+static Texture2D *weaponTexture;      // Player's weapon texture
+static Texture2D *keyTexture;         // Key texture
+static Texture2D *impTextures[56];    // Array of individual enemy textures
+
+// Sounds (owned by the asset cache)
+static Sound *footstepSound;
+static Sound *victorySound;
+static Sound *keyPickupSound;
+static Sound *playerHitSound;         // Sound when player takes damage
+static Sound *gameOverSound;          // Game over sound
+static Sound *shootSound;
+
+// Asset lifetime scopes
+static AssetScope globalAssets;       // Assets used for the whole session
+static AssetScope levelAssets;        // Assets referenced by the current level
+
+// Empty assets used in headless mode (raylib ignores unloaded sounds, which gives a null audio output)
+static Texture2D nullTexture;
+static Sound nullSound;
 
 // Raycasting engine variables
 static float projPlaneDistance;       // Distance to projection plane
+static float cameraPlaneScale;        // tan(FOV/2), length of the camera plane
 static int numRays;                   // Number of rays for raycasting
-static const float raycastMaxDistance = 20.0f; // Maximum raycast distance
-static void CheckPlayerInteractions(void);
+static const float raycastMaxDistance = FOG_END + 1.5f; // Maximum raycast distance (farther walls are black in the fog)
+static void CheckPlayerInteractions(float deltaTime);
+
+// Sounds the simulation can trigger (see QueueSound)
+typedef enum {
+    SOUND_FOOTSTEP   = 1 << 0,  // Only started if it isn't playing already
+    SOUND_VICTORY    = 1 << 1,
+    SOUND_KEY_PICKUP = 1 << 2,
+    SOUND_PLAYER_HIT = 1 << 3,
+    SOUND_GAME_OVER  = 1 << 4,
+    SOUND_SHOOT      = 1 << 5
+} GameSound;
 
 // Definitions for enemy animations
 #define ANIM_WALK_FRONT          0  // 000-003: Walk from front
@@ -82,7 +159,9 @@ static const AnimationRange animationRanges[] = {
 // Initialize player
 static void InitPlayer(void) {
     player.position = GridToWorld((int)gameMaze.startPos.x, (int)gameMaze.startPos.y);
+    player.prevPosition = player.position;
     player.angle = 0.0f;
+    player.prevAngle = player.angle;
     player.health = 100;
     player.keys = 0;
     player.shootCooldown = 0.0f;
@@ -90,47 +169,94 @@ static void InitPlayer(void) {
     katanaAnim.isSwinging = false;
     katanaAnim.swingTimer = 0.0f;
     katanaAnim.swingDuration = 0.5f; // Attack duration
+    katanaAnim.currentFrame = 0;
+    katanaAnim.frameTimer = 0.0f;
+}
+
+// Initialize the weapon and crosshair layout (read by the renderer only, set once)
+static void InitHUD(void) {
     katanaAnim.basePosition = (Vector2){GetScreenWidth() - 250, GetScreenHeight() - 200};
     katanaAnim.swingOffset = (Vector2){-30.0f, -20.0f};
     katanaAnim.scale = 7.0f; // Increase scale for better visibility
-    katanaAnim.currentFrame = 0;
-    katanaAnim.frameTimer = 0.0f;
     
     crosshair.position = (Vector2){ GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
     crosshair.size = 15.0f;
     crosshair.color = WHITE;
+}
+
+// Trigger a sound (any thread), it plays on the main thread with PlayQueuedSounds
+static void QueueSound(GameSound sound) {
+    atomic_fetch_or_explicit(&queuedSounds, (unsigned int)sound, memory_order_relaxed);
+}
+
+// Play the sounds triggered since the last call (main thread)
+static void PlayQueuedSounds(void) {
+    unsigned int sounds = atomic_exchange_explicit(&queuedSounds, 0, memory_order_relaxed);
+    if (sounds == 0 || headlessMode) return;
+    
+    if ((sounds & SOUND_FOOTSTEP) && !IsSoundPlaying(*footstepSound)) PlaySound(*footstepSound);
+    if (sounds & SOUND_VICTORY) PlaySound(*victorySound);
+    if (sounds & SOUND_KEY_PICKUP) PlaySound(*keyPickupSound);
+    if (sounds & SOUND_PLAYER_HIT) PlaySound(*playerHitSound);
+    if (sounds & SOUND_GAME_OVER) PlaySound(*gameOverSound);
+    if (sounds & SOUND_SHOOT) PlaySound(*shootSound);
+}
+
+// Acquire the assets used for the whole session (wall, weapon and sounds)
+static void AcquireGlobalAssets(void) {
+    char filename[64];
+    char fallback[64];
     
-    // Load weapon animation frames
+    wallTextures[0] = AcquireTexture(&globalAssets, "assets/textures/wall.png", NULL);
+    weaponTexture = AcquireTexture(&globalAssets, "assets/textures/weapons/tile003.png", NULL);
+    
+    // Weapon animation frames (with the alternative path as fallback)
     for (int i = 0; i < 5; i++) {
-        char filename[100];
         sprintf(filename, "assets/textures/weapons/tile%03d.png", i + 6);
-        katanaAnim.frames[i] = LoadTexture(filename);
-        
-        // Verify if texture loaded correctly
-        if (katanaAnim.frames[i].id == 0) {
-            printf("Error loading texture: %s\n", filename);
-            
-            // Try loading from alternative path
-            sprintf(filename, "assets/textures/weaponsAttachment/tile%03d.png", i + 6);
-            katanaAnim.frames[i] = LoadTexture(filename);
-            
-            if (katanaAnim.frames[i].id == 0) {
-                printf("Error loading alternative texture: %s\n", filename);
-            } else {
-                printf("Alternative texture loaded successfully: %s\n", filename);
-            }
-        } else {
-            printf("Texture loaded successfully: %s, ID: %u\n", filename, katanaAnim.frames[i].id);
-        }
+        sprintf(fallback, "assets/textures/weaponsAttachment/tile%03d.png", i + 6);
+        katanaAnim.frames[i] = AcquireTexture(&globalAssets, filename, fallback);
     }
+    
+    footstepSound = AcquireSound(&globalAssets, "assets/sounds/footsteps.wav");
+    victorySound = AcquireSound(&globalAssets, "assets/sounds/victory.wav");
+    keyPickupSound = AcquireSound(&globalAssets, "assets/sounds/key.wav");
+    playerHitSound = AcquireSound(&globalAssets, "assets/sounds/damage.mp3");
+    gameOverSound = AcquireSound(&globalAssets, "assets/sounds/victory.wav");
+    shootSound = AcquireSound(&globalAssets, "assets/sounds/shoot.mp3");
 }
 
-// Load enemy textures
-static void LoadEnemyTextures(void) {
+// Point every texture and sound at empty assets (headless mode)
+static void BindNullAssets(void) {
+    wallTextures[0] = &nullTexture;
+    weaponTexture = &nullTexture;
+    keyTexture = &nullTexture;
+    exitDoor.openTexture = &nullTexture;
+    exitDoor.closedTexture = &nullTexture;
+    for (int i = 0; i < 5; i++) katanaAnim.frames[i] = &nullTexture;
+    for (int i = 0; i < 56; i++) impTextures[i] = &nullTexture;
+    
+    footstepSound = &nullSound;
+    victorySound = &nullSound;
+    keyPickupSound = &nullSound;
+    playerHitSound = &nullSound;
+    gameOverSound = &nullSound;
+    shootSound = &nullSound;
+}
+
+// Acquire the sprite assets of a level (key, exit door and enemy frames)
+static void AcquireLevelAssets(AssetScope *scope) {
     char filename[64];
+    
+    if (headlessMode) return;
+    
+    keyTexture = AcquireTexture(scope, "assets/textures/key.png", NULL);
+    exitDoor.openTexture = AcquireTexture(scope, "assets/textures/door_open.png", NULL);
+    exitDoor.closedTexture = AcquireTexture(scope, "assets/textures/door_closed.png", NULL);
+    
+    // Individual enemy textures
     for (int i = 0; i < 56; i++) {
         sprintf(filename, "assets/textures/imp/tile%03d.png", i);
-        impTextures[i] = LoadTexture(filename);
+        impTextures[i] = AcquireTexture(scope, filename, NULL);
     }
 }
 
@@ -150,90 +276,95 @@ static int GetTextureIndex(int animationType, int currentFrame) {
     return startFrame + frameIndex;
 }
 
-// Initialize enemies
-static void InitEnemies(void) {
-    enemyCount = 0;
-    spriteCount = 0;
-    
-     // Load key sprites first
-     for (int y = 0; y < MAZE_HEIGHT; y++) {
-        for (int x = 0; x < MAZE_WIDTH; x++) {
-            if (GetCellType(&gameMaze, x, y) == CELL_KEY && spriteCount < MAX_SPRITES) {
-                sprites[spriteCount].position = GridToWorld(x, y);
-                sprites[spriteCount].texture = keyTexture;
-                sprites[spriteCount].active = true;
-                sprites[spriteCount].type = CELL_KEY;
-                // For keys, we use a simple frame that covers the entire texture
-                sprites[spriteCount].frame = (Rectangle){ 0, 0, keyTexture.width, keyTexture.height };
-                
-                // Debug to verify key textures
-                printf("Key sprite added. Texture ID: %u, Width: %d, Height: %d\n", 
-                      keyTexture.id, keyTexture.width, keyTexture.height);
-                
-                spriteCount++;
-            }
-        }
+// Create the keys, the exit door and the enemies from the spawns precomputed with the level
+static void InitEntities(const Level *level) {
+    ClearEntities(&entities);
+    
+    // Keys
+    for (int i = 0; i < level->keyCount; i++) {
+        EntityHandle key = CreateEntity(&entities);
+        if (!IsEntityAlive(&entities, key)) break;
+        
+        TransformComponent *transform = AddComponent(&entities, key, COMPONENT_TRANSFORM);
+        transform->position = level->keyPositions[i];
+        transform->prevPosition = transform->position;
+        
+        RenderComponent *render = AddComponent(&entities, key, COMPONENT_RENDER);
+        render->texture = keyTexture;
+        render->type = CELL_KEY;
     }
     
-    // Add the sprite of the exit door
-    sprites[spriteCount].position = exitDoor.position;
-    sprites[spriteCount].texture = exitDoor.isOpen ? exitDoor.openTexture : exitDoor.closedTexture;
-    sprites[spriteCount].active = true;
-    sprites[spriteCount].type = CELL_EXIT;
-    sprites[spriteCount].frame = (Rectangle){ 
-        0, 0, 
-        sprites[spriteCount].texture.width, 
-        sprites[spriteCount].texture.height 
-    };
-    exitDoor.spriteIndex = spriteCount; // Store the index of the door sprite
-    spriteCount++;
-    
-    // Search the maze for enemy positions
-    for (int y = 0; y < MAZE_HEIGHT; y++) {
-        for (int x = 0; x < MAZE_WIDTH; x++) {
-            if (GetCellType(&gameMaze, x, y) == CELL_ENEMY && enemyCount < MAX_ENEMIES) {
-                enemies[enemyCount].position = GridToWorld(x, y);
-                enemies[enemyCount].angle = ((float)rand() / RAND_MAX) * 2 * PI;
-                enemies[enemyCount].active = true;
-                enemies[enemyCount].health = ENEMY_HEALTH;
-                enemies[enemyCount].attackCooldown = 0.0f;
-                enemies[enemyCount].moveTimer = ((float)rand() / RAND_MAX) * 2.0f;
-                enemies[enemyCount].direction = (Vector2){
-                    cosf(enemies[enemyCount].angle),
-                    sinf(enemies[enemyCount].angle)
-                };
-                
-                // Setup animation
-                enemies[enemyCount].anim.currentAnim = ANIM_WALK_FRONT;
-                enemies[enemyCount].anim.currentFrame = 0;
-                enemies[enemyCount].anim.frameTimer = 0.0f;
-                enemies[enemyCount].anim.isPlaying = true;
-                enemies[enemyCount].anim.loop = true;
-                enemies[enemyCount].isDying = false;
-                
-                // Add sprite for the enemy
-                if (spriteCount < MAX_SPRITES) {
-                    sprites[spriteCount].position = enemies[enemyCount].position;
-                    sprites[spriteCount].texture = impTextures[0]; // Initial texture
-                    sprites[spriteCount].active = true;
-                    sprites[spriteCount].type = CELL_ENEMY;
-                    
-                    // Setup initial frame
-                    sprites[spriteCount].frame = (Rectangle){ 0, 0, impTextures[0].width, impTextures[0].height };
-                    sprites[spriteCount].anim = enemies[enemyCount].anim;
-                    
-                    // Save reference to sprite in the enemy
-                    enemies[enemyCount].spriteIndex = spriteCount;
-                    
-                    spriteCount++;
-                }
-                
-                enemyCount++;
-            }
-        }
+    // Exit door
+    exitDoor.entity = CreateEntity(&entities);
+    if (IsEntityAlive(&entities, exitDoor.entity)) {
+        TransformComponent *transform = AddComponent(&entities, exitDoor.entity, COMPONENT_TRANSFORM);
+        transform->position = level->exitPosition;
+        transform->prevPosition = transform->position;
+        
+        RenderComponent *render = AddComponent(&entities, exitDoor.entity, COMPONENT_RENDER);
+        render->texture = exitDoor.isOpen ? exitDoor.openTexture : exitDoor.closedTexture;
+        render->type = CELL_EXIT;
+    }
+    
+    // Create the enemies at their spawn positions
+    for (int i = 0; i < level->enemyCount && i < MAX_ENEMIES; i++) {
+        const EnemySpawn *spawn = &level->enemySpawns[i];
+        
+        EntityHandle enemy = CreateEntity(&entities);
+        if (!IsEntityAlive(&entities, enemy)) break;
+        
+        TransformComponent *transform = AddComponent(&entities, enemy, COMPONENT_TRANSFORM);
+        transform->position = spawn->position;
+        transform->prevPosition = spawn->position;
+        transform->angle = spawn->angle;
+        
+        RenderComponent *render = AddComponent(&entities, enemy, COMPONENT_RENDER);
+        render->texture = impTextures[0]; // Initial texture
+        render->type = CELL_ENEMY;
+        
+        HealthComponent *health = AddComponent(&entities, enemy, COMPONENT_HEALTH);
+        health->health = ENEMY_HEALTH;
+        health->isDying = false;
+        
+        AIComponent *ai = AddComponent(&entities, enemy, COMPONENT_AI);
+        ai->attackCooldown = 0.0f;
+        ai->moveTimer = spawn->moveTimer;
+        ai->direction = (Vector2){ cosf(spawn->angle), sinf(spawn->angle) };
+        
+        // Setup animation
+        Animation *anim = AddComponent(&entities, enemy, COMPONENT_ANIMATION);
+        anim->currentAnim = ANIM_WALK_FRONT;
+        anim->currentFrame = 0;
+        anim->frameTimer = 0.0f;
+        anim->isPlaying = true;
+        anim->loop = true;
     }
 }
 
+// Start a new level: maze, player, exit door and enemies (assets must be loaded)
+// In pipelined mode this runs on the simulation thread, so it doesn't touch the asset cache
+// (main thread only): every level uses the sprites InitGame acquired into levelAssets
+static void InitLevel(void) {
+    TraceBegin("InitLevel");
+    
+    // Swap in a level generated in the background and give the previous one back
+    Level *level = AcquireLevel();
+    ReleaseLevel(currentLevel);
+    currentLevel = level;
+    gameMaze = level->maze;
+    
+    // Initialize player
+    InitPlayer();
+    
+    exitDoor.isOpen = false;
+    exitDoor.active = true;
+    
+    // Keys, exit door and enemies
+    InitEntities(level);
+    
+    TraceEnd("InitLevel");
+}
+
 // Check player collisions with the world
 static bool CheckWallCollision(Vector2 pos) {
     // Convert world position to grid coordinates
@@ -246,40 +377,34 @@ static bool CheckWallCollision(Vector2 pos) {
 }
 
 // Move player
-static void MovePlayer(void) {
-    float moveSpeed = PLAYER_SPEED * GetFrameTime();
-    float rotSpeed = PLAYER_ROT_SPEED * GetFrameTime();
+static void MovePlayer(unsigned int inputDown, float deltaTime) {
+    float moveSpeed = PLAYER_SPEED * deltaTime;
+    float rotSpeed = PLAYER_ROT_SPEED * deltaTime;
 
     // Rotate player
-    if (IsKeyDown(KEY_LEFT)) player.angle -= rotSpeed;
-    if (IsKeyDown(KEY_A)) player.angle -= rotSpeed;
-    if (IsKeyDown(KEY_D)) player.angle += rotSpeed;
-    if (IsKeyDown(KEY_RIGHT)) player.angle += rotSpeed;
+    if (inputDown & INPUT_TURN_LEFT) player.angle -= rotSpeed;
+    if (inputDown & INPUT_TURN_RIGHT) player.angle += rotSpeed;
     
     // Normalize angle
     player.angle = NormalizeAngle(player.angle);
     
     // Calculate direction vector
-    float dirX = cosf(player.angle);
-    float dirY = sinf(player.angle);
+    float dirX, dirY;
+    FastSinCos(player.angle, &dirY, &dirX);
     
     // Move forward/backward
     Vector2 newPos = player.position;
     
-    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) {
+    if (inputDown & INPUT_FORWARD) {
         newPos.x += dirX * moveSpeed;
         newPos.y += dirY * moveSpeed;
-        if (!IsSoundPlaying(footstepSound)) {
-            PlaySound(footstepSound);
-        }
+        QueueSound(SOUND_FOOTSTEP);
     }
     
-    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) {
+    if (inputDown & INPUT_BACKWARD) {
         newPos.x -= dirX * moveSpeed;
         newPos.y -= dirY * moveSpeed;
-        if (!IsSoundPlaying(footstepSound)) {
-            PlaySound(footstepSound);
-        }
+        QueueSound(SOUND_FOOTSTEP);
     }
     
     // Check collisions separately in X and Y to allow wall sliding
@@ -298,11 +423,11 @@ static void MovePlayer(void) {
     }
     
     // Check interactions with objects
-    CheckPlayerInteractions();
+    CheckPlayerInteractions(deltaTime);
 }
 
 // Determine the enemy animation based on its state and relative angle to the player
-static int DetermineEnemyAnimation(Enemy* enemy, bool isAttacking, bool isDying) {
+static int DetermineEnemyAnimation(const TransformComponent *enemy, bool isAttacking, bool isDying) {
     if (isDying) {
         return ANIM_DEATH;
     }
@@ -311,7 +436,7 @@ static int DetermineEnemyAnimation(Enemy* enemy, bool isAttacking, bool isDying)
         // Calculate relative angle between player and enemy
         float dx = player.position.x - enemy->position.x;
         float dy = player.position.y - enemy->position.y;
-        float targetAngle = atan2f(dy, dx);
+        float targetAngle = FastAtan2(dy, dx);
         float angleDiff = NormalizeAngle(player.angle - targetAngle);
         
         // Convert angle difference to degrees for easier comparisons
@@ -339,7 +464,7 @@ static int DetermineEnemyAnimation(Enemy* enemy, bool isAttacking, bool isDying)
         // Calculate relative angle for walking animation
         float dx = player.position.x - enemy->position.x;
         float dy = player.position.y - enemy->position.y;
-        float targetAngle = atan2f(dy, dx);
+        float targetAngle = FastAtan2(dy, dx);
         float angleDiff = NormalizeAngle(player.angle - targetAngle);
         
         // Convert angle difference to degrees
@@ -364,192 +489,185 @@ static int DetermineEnemyAnimation(Enemy* enemy, bool isAttacking, bool isDying)
     }
 }
 
-// Update enemies
-static void UpdateEnemies(void) {
-    float deltaTime = GetFrameTime();
-    
-    for (int i = 0; i < enemyCount; i++) {
-        if (!enemies[i].active) continue;
+// Update enemies: choose their animation, attack the player or move (AI components)
+static void UpdateEnemies(float deltaTime) {
+    for (int i = 0; i < entities.count[COMPONENT_AI]; i++) {
+        AIComponent *ai = &entities.ais[i];
+        EntityHandle enemy = GetComponentOwner(&entities, COMPONENT_AI, i);
+        TransformComponent *transform = GetComponent(&entities, enemy, COMPONENT_TRANSFORM);
+        HealthComponent *health = GetComponent(&entities, enemy, COMPONENT_HEALTH);
+        Animation *anim = GetComponent(&entities, enemy, COMPONENT_ANIMATION);
         
         // Update attack timer
-        if (enemies[i].attackCooldown > 0) {
-            enemies[i].attackCooldown -= deltaTime;
+        if (ai->attackCooldown > 0) {
+            ai->attackCooldown -= deltaTime;
         }
         
-        // Update animation
-        enemies[i].anim.frameTimer += deltaTime;
-        
         // Determine which animation to use based on state
         float distToPlayer = Distance(
-            enemies[i].position.x, enemies[i].position.y,
+            transform->position.x, transform->position.y,
             player.position.x, player.position.y
         );
         
         bool isAttacking = (distToPlayer <= ENEMY_ATTACK_RANGE);
-        int newAnimType = DetermineEnemyAnimation(&enemies[i], isAttacking, enemies[i].isDying);
+        int newAnimType = DetermineEnemyAnimation(transform, isAttacking, health->isDying);
         
         // If animation changed, reset
-        if (enemies[i].anim.currentAnim != newAnimType) {
-            enemies[i].anim.currentAnim = newAnimType;
-            enemies[i].anim.currentFrame = 0;
-            enemies[i].anim.frameTimer = 0.0f;
-            enemies[i].anim.loop = animationRanges[newAnimType].loop;
-        }
-        
-        // Change frame if it's time
-        if (enemies[i].anim.frameTimer >= ENEMY_FRAME_TIME) {
-            enemies[i].anim.frameTimer = 0.0f;
-            
-            // Advance to next frame
-            enemies[i].anim.currentFrame++;
-            
-            // Get frame range for this animation
-            int startFrame = animationRanges[enemies[i].anim.currentAnim].startFrame;
-            int endFrame = animationRanges[enemies[i].anim.currentAnim].endFrame;
-            int frameCount = endFrame - startFrame + 1;
-            
-            // If we reached the end of animation
-            if (enemies[i].anim.currentFrame >= frameCount) {
-                if (enemies[i].anim.loop) {
-                    enemies[i].anim.currentFrame = 0; // Return to start
-                } else {
-                    enemies[i].anim.currentFrame = frameCount - 1; // Stay on last frame
-                    
-                    // If it's death animation and finished
-                    if (enemies[i].anim.currentAnim == ANIM_DEATH) {
-                        enemies[i].active = false;
-                    }
-                }
-            }
+        if (anim->currentAnim != newAnimType) {
+            anim->currentAnim = newAnimType;
+            anim->currentFrame = 0;
+            anim->frameTimer = 0.0f;
+            anim->loop = animationRanges[newAnimType].loop;
         }
         
         // Update enemy angle to face player
-        float dx = player.position.x - enemies[i].position.x;
-        float dy = player.position.y - enemies[i].position.y;
-        float targetAngle = atan2f(dy, dx);
-        enemies[i].angle = targetAngle;
-        
-        // Update enemy sprite
-        int spriteIndex = enemies[i].spriteIndex;
-        if (spriteIndex >= 0 && spriteIndex < spriteCount) {
-            // Get correct texture index
-            int textureIndex = GetTextureIndex(
-                enemies[i].anim.currentAnim, 
-                enemies[i].anim.currentFrame
-            );
-            
-            // Update sprite texture
-            sprites[spriteIndex].texture = impTextures[textureIndex];
-            
-            // Update frame to cover entire texture
-            sprites[spriteIndex].frame = (Rectangle){
-                0, 0, 
-                (float)impTextures[textureIndex].width, 
-                (float)impTextures[textureIndex].height
-            };
-            
-            // Update sprite position with enemy position
-            sprites[spriteIndex].position = enemies[i].position;
-            
-            // Also update sprite animation
-            sprites[spriteIndex].anim = enemies[i].anim;
-        }
+        float dx = player.position.x - transform->position.x;
+        float dy = player.position.y - transform->position.y;
+        float targetAngle = FastAtan2(dy, dx);
+        transform->angle = targetAngle;
         
         // If enemy is in attack range
         if (distToPlayer <= ENEMY_ATTACK_RANGE) {
             // Attack player if cooldown allows
-            if (enemies[i].attackCooldown <= 0) {
+            if (ai->attackCooldown <= 0) {
                 player.health -= ENEMY_ATTACK_DAMAGE;
-                enemies[i].attackCooldown = ENEMY_ATTACK_COOLDOWN;
+                ai->attackCooldown = ENEMY_ATTACK_COOLDOWN;
                 
                 // Play damage sound
-                PlaySound(playerHitSound);
+                QueueSound(SOUND_PLAYER_HIT);
                 
                 // Check if player has died
                 if (player.health <= 0) {
                     player.health = 0;
                     currentState = GAME_OVER;
-                    PlaySound(gameOverSound);
+                    QueueSound(SOUND_GAME_OVER);
                 }
             }
         }
         // If not in attack range, move
         else {
             // Update movement timer
-            enemies[i].moveTimer -= deltaTime;
+            ai->moveTimer -= deltaTime;
             
             // Change direction randomly
-            if (enemies[i].moveTimer <= 0) {
+            if (ai->moveTimer <= 0) {
                 // Choose between following player or moving randomly
                 if (distToPlayer < 5.0f && ((float)rand() / RAND_MAX) < 0.7f) {
                     // Follow player
-                    float dx = player.position.x - enemies[i].position.x;
-                    float dy = player.position.y - enemies[i].position.y;
+                    float dx = player.position.x - transform->position.x;
+                    float dy = player.position.y - transform->position.y;
                     float length = sqrtf(dx*dx + dy*dy);
                     
                     if (length > 0) {
-                        enemies[i].direction.x = dx / length;
-                        enemies[i].direction.y = dy / length;
+                        ai->direction.x = dx / length;
+                        ai->direction.y = dy / length;
                     }
                 } else {
                     // Move randomly
                     float randomAngle = ((float)rand() / RAND_MAX) * 2 * PI;
-                    enemies[i].direction.x = cosf(randomAngle);
-                    enemies[i].direction.y = sinf(randomAngle);
+                    FastSinCos(randomAngle, &ai->direction.y, &ai->direction.x);
                 }
                 
                 // Reset timer (between 1 and 3 seconds)
-                enemies[i].moveTimer = 1.0f + ((float)rand() / RAND_MAX) * 2.0f;
+                ai->moveTimer = 1.0f + ((float)rand() / RAND_MAX) * 2.0f;
             }
             
             // Calculate new position
-            Vector2 newPos = enemies[i].position;
-            newPos.x += enemies[i].direction.x * ENEMY_SPEED * deltaTime;
-            newPos.y += enemies[i].direction.y * ENEMY_SPEED * deltaTime;
+            Vector2 newPos = transform->position;
+            newPos.x += ai->direction.x * ENEMY_SPEED * deltaTime;
+            newPos.y += ai->direction.y * ENEMY_SPEED * deltaTime;
             
             // Check collisions separately in X and Y
-            Vector2 testPos = enemies[i].position;
+            Vector2 testPos = transform->position;
             testPos.x = newPos.x;
             
             if (!CheckWallCollision(testPos)) {
-                enemies[i].position.x = testPos.x;
+                transform->position.x = testPos.x;
             } else {
                 // If collision, invert X direction
-                enemies[i].direction.x *= -1;
+                ai->direction.x *= -1;
             }
             
-            testPos = enemies[i].position;
+            testPos = transform->position;
             testPos.y = newPos.y;
             
             if (!CheckWallCollision(testPos)) {
-                enemies[i].position.y = testPos.y;
+                transform->position.y = testPos.y;
             } else {
                 // If collision, invert Y direction
-                enemies[i].direction.y *= -1;
+                ai->direction.y *= -1;
             }
         }
     }
 }
 
+// Advance the animations and show their current frame (animation and render components),
+// entities whose death animation ended are destroyed
+static void UpdateAnimations(float deltaTime) {
+    // Backwards: destroying an entity moves the last animation into the current entry
+    for (int i = entities.count[COMPONENT_ANIMATION] - 1; i >= 0; i--) {
+        Animation *anim = &entities.animations[i];
+        EntityHandle entity = GetComponentOwner(&entities, COMPONENT_ANIMATION, i);
+        
+        anim->frameTimer += deltaTime;
+        
+        // Change frame if it's time
+        if (anim->frameTimer >= ENEMY_FRAME_TIME) {
+            anim->frameTimer = 0.0f;
+            
+            // Advance to next frame
+            anim->currentFrame++;
+            
+            // Get frame range for this animation
+            int startFrame = animationRanges[anim->currentAnim].startFrame;
+            int endFrame = animationRanges[anim->currentAnim].endFrame;
+            int frameCount = endFrame - startFrame + 1;
+            
+            // If we reached the end of animation
+            if (anim->currentFrame >= frameCount) {
+                if (anim->loop) {
+                    anim->currentFrame = 0; // Return to start
+                } else {
+                    anim->currentFrame = frameCount - 1; // Stay on last frame
+                    
+                    // If it's death animation and finished
+                    if (anim->currentAnim == ANIM_DEATH) {
+                        DestroyEntity(&entities, entity);
+                        continue;
+                    }
+                }
+            }
+        }
+        
+        // Texture of the current frame
+        RenderComponent *render = GetComponent(&entities, entity, COMPONENT_RENDER);
+        if (render != NULL) render->texture = impTextures[GetTextureIndex(anim->currentAnim, anim->currentFrame)];
+    }
+}
+
 // Check player attacks against enemies
 static void CheckPlayerAttacks(void) {
     // Only check if the player is attacking
     if (!katanaAnim.isSwinging) return;
     
     // Play shooting sound
-    PlaySound(shootSound);
+    QueueSound(SOUND_SHOOT);
     
     // Get the ray direction from the camera
-    float playerDirX = cosf(player.angle);
-    float playerDirY = sinf(player.angle);
+    float playerDirX, playerDirY;
+    FastSinCos(player.angle, &playerDirY, &playerDirX);
     
-    // Check each enemy
-    for (int i = 0; i < enemyCount; i++) {
-        if (!enemies[i].active || enemies[i].isDying) continue;
+    // Check each enemy (anything with health)
+    for (int i = 0; i < entities.count[COMPONENT_HEALTH]; i++) {
+        HealthComponent *health = &entities.healths[i];
+        if (health->isDying) continue;
+        
+        EntityHandle enemy = GetComponentOwner(&entities, COMPONENT_HEALTH, i);
+        const TransformComponent *transform = GetComponent(&entities, enemy, COMPONENT_TRANSFORM);
         
         // Calculate vector from player to enemy
-        float dx = enemies[i].position.x - player.position.x;
-        float dy = enemies[i].position.y - player.position.y;
+        float dx = transform->position.x - player.position.x;
+        float dy = transform->position.y - player.position.y;
         
         // Calculate distance to enemy
         float dist = sqrtf(dx*dx + dy*dy);
@@ -586,15 +704,19 @@ static void CheckPlayerAttacks(void) {
             
             // If we didn't hit a wall before reaching the enemy, damage it
             if (!hitWall) {
-                enemies[i].health -= PLAYER_ATTACK_DAMAGE;
+                health->health -= PLAYER_ATTACK_DAMAGE;
                 
                 
                 // Check if the enemy has died
-                if (enemies[i].health <= 0) {
-                    enemies[i].isDying = true;
-                    enemies[i].anim.currentAnim = ANIM_DEATH;
-                    enemies[i].anim.currentFrame = 0;
-                    enemies[i].anim.loop = false;
+                if (health->health <= 0) {
+                    health->isDying = true;
+                    
+                    Animation *anim = GetComponent(&entities, enemy, COMPONENT_ANIMATION);
+                    if (anim != NULL) {
+                        anim->currentAnim = ANIM_DEATH;
+                        anim->currentFrame = 0;
+                        anim->loop = false;
+                    }
                 }
             }
         }
@@ -602,44 +724,41 @@ static void CheckPlayerAttacks(void) {
 }
 
 // Check player interactions with objects
-static void CheckPlayerInteractions(void) {
+static void CheckPlayerInteractions(float deltaTime) {
     // Update door state based on keys
     bool oldState = exitDoor.isOpen;
     exitDoor.isOpen = (player.keys >= MAX_KEYS);
     
     // Only update the texture if the state has changed
-    if (oldState != exitDoor.isOpen && exitDoor.spriteIndex >= 0 && exitDoor.spriteIndex < spriteCount) {
-        sprites[exitDoor.spriteIndex].texture = exitDoor.isOpen ? 
-            exitDoor.openTexture : exitDoor.closedTexture;
-        
-        // Debug print
-        printf("Door state changed to: %s\n", exitDoor.isOpen ? "OPEN" : "CLOSED");
-        printf("Door sprite texture ID: %u\n", sprites[exitDoor.spriteIndex].texture.id);
-        
-        sprites[exitDoor.spriteIndex].frame = (Rectangle){ 
-            0, 0, 
-            sprites[exitDoor.spriteIndex].texture.width, 
-            sprites[exitDoor.spriteIndex].texture.height 
-        };
+    RenderComponent *doorRender = GetComponent(&entities, exitDoor.entity, COMPONENT_RENDER);
+    if (oldState != exitDoor.isOpen && doorRender != NULL) {
+        doorRender->texture = exitDoor.isOpen ? exitDoor.openTexture : exitDoor.closedTexture;
+        TraceLog(LOG_DEBUG, "GAME: Exit door %s", exitDoor.isOpen ? "opened" : "closed");
     }
     
-    // Check interactions with sprites (keys and exit door)
-    for (int i = 0; i < spriteCount; i++) {
-        if (!sprites[i].active) continue;
+    // Check interactions with sprites (keys and exit door), backwards since picked up keys
+    // are destroyed
+    for (int i = entities.count[COMPONENT_RENDER] - 1; i >= 0; i--) {
+        CellType type = entities.renders[i].type;
+        if (type != CELL_KEY && type != CELL_EXIT) continue;
+        
+        EntityHandle entity = GetComponentOwner(&entities, COMPONENT_RENDER, i);
+        const TransformComponent *transform = GetComponent(&entities, entity, COMPONENT_TRANSFORM);
+        Vector2 position = transform->position;   // Copy, destroying the key frees the component
         
         // Calculate distance to sprite
         float dist = Distance(player.position.x, player.position.y, 
-                             sprites[i].position.x, sprites[i].position.y);
+                             position.x, position.y);
         
         // If we're close enough
         if (dist < 0.5f) {
             // If it's a key
-            if (sprites[i].type == CELL_KEY) {
+            if (type == CELL_KEY) {
                 player.keys++;
-                sprites[i].active = false;
+                DestroyEntity(&entities, entity);
                 
                 // Also remove the key from grid to avoid duplicates
-                Vector2 spriteGridPos = WorldToGrid(sprites[i].position);
+                Vector2 spriteGridPos = WorldToGrid(position);
                 int spriteGridX = (int)spriteGridPos.x;
                 int spriteGridY = (int)spriteGridPos.y;
                 
@@ -647,12 +766,12 @@ static void CheckPlayerInteractions(void) {
                     gameMaze.grid[spriteGridY][spriteGridX] = CELL_EMPTY;
                 }
                 
-                PlaySound(keyPickupSound);
+                QueueSound(SOUND_KEY_PICKUP);
             }
             // If it's the exit door and it's open
-            else if (sprites[i].type == CELL_EXIT && exitDoor.isOpen) {
+            else if (type == CELL_EXIT && exitDoor.isOpen) {
                 currentState = GAME_VICTORY;
-                PlaySound(victorySound);
+                QueueSound(SOUND_VICTORY);
                 exitMessageTimer = 3.0f; // Show message for 3 seconds
             }
         }
@@ -669,297 +788,130 @@ static void CheckPlayerInteractions(void) {
     }
 
     if (showExitMessage) {
-        exitMessageTimer -= GetFrameTime();
+        exitMessageTimer -= deltaTime;
         if (exitMessageTimer <= 0.0f) {
             showExitMessage = false;
         }
     }
 }
-// Raycasting engine for 3D rendering
-static void RenderRaycasting(float zBuffer[]) {
-    float fovHalf = DegToRad(FOV / 2);
-    float screenWidth = (float)GetScreenWidth();
-    float screenHeight = (float)GetScreenHeight();
-    
-    // Calculate camera direction and plane
-    float playerDirX = cosf(player.angle);
-    float playerDirY = sinf(player.angle);
-    float planeX = -playerDirY * tanf(fovHalf);
-    float planeY = playerDirX * tanf(fovHalf);
-    
+// Color multiplied by a shade tint
+static Color ApplyTint(Color color, Color tint) {
+    return (Color){ (unsigned char)(color.r * tint.r / 255), (unsigned char)(color.g * tint.g / 255),
+                    (unsigned char)(color.b * tint.b / 255), color.a };
+}
+
+// Shading pass of the walls: draw the columns found by the traversal pass
+static void RenderWalls(const WorldSnapshot *world) {
     ClearBackground(BLACK);
     
-    // Draw floor/ceiling
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight()/2, (Color){25, 25, 25, 255});                 // Ceiling
-    DrawRectangle(0, GetScreenHeight()/2, GetScreenWidth(), GetScreenHeight()/2, (Color){50, 50, 50, 255}); // Floor
+    // Draw floor/ceiling: lit by the camera cell, solid up to the start of the fog and fading
+    // to black at its end (the rows of a distance are halfHeight/distance from the horizon)
+    int width = GetScreenWidth();
+    int halfHeight = GetScreenHeight()/2;
+    int fogStartRows = (int)(halfHeight / FOG_START);
+    int fogEndRows = (int)(halfHeight / FOG_END);
+    int cellX = (int)viewCamera.position.x;
+    int cellY = (int)viewCamera.position.y;
+    int light = IsPosInBounds(cellX, cellY) ? world->maze.light[cellY][cellX] : LIGHT_AMBIENT;
+    Color surfaceTint = GetShadeTint(GetShadeLevel(&shadeTable, 0, light, 0.0f));
+    Color ceilingColor = ApplyTint((Color){25, 25, 25, 255}, surfaceTint);
+    Color floorColor = ApplyTint((Color){50, 50, 50, 255}, surfaceTint);
+
+    DrawRectangle(0, 0, width, halfHeight - fogStartRows, ceilingColor);
+    DrawRectangleGradientV(0, halfHeight - fogStartRows, width, fogStartRows - fogEndRows, ceilingColor, BLACK);
+    DrawRectangleGradientV(0, halfHeight + fogEndRows, width, fogStartRows - fogEndRows, BLACK, floorColor);
+    DrawRectangle(0, halfHeight + fogStartRows, width, halfHeight - fogStartRows, floorColor);
     
-    // Cast rays
-    for (int x = 0; x < screenWidth; x++) {
-        // Calculate x-position in camera space
-        float cameraX = 2.0f * x / screenWidth - 1.0f;
-        
-        // Calculate ray direction
-        float rayDirX = playerDirX + planeX * cameraX;
-        float rayDirY = playerDirY + planeY * cameraX;
-        
-        // Current map position
-        int mapX = (int)player.position.x;
-        int mapY = (int)player.position.y;
-        
-        // Length of ray from one side to next
-        float deltaDistX = fabsf(rayDirX) < 0.00001f ? 1e30f : fabsf(1.0f / rayDirX);
-        float deltaDistY = fabsf(rayDirY) < 0.00001f ? 1e30f : fabsf(1.0f / rayDirY);
-        
-        // Calculate step and initial side distance
-        int stepX, stepY;
-        float sideDistX, sideDistY;
-        
-        if (rayDirX < 0) {
-            stepX = -1;
-            sideDistX = (player.position.x - mapX) * deltaDistX;
-        } else {
-            stepX = 1;
-            sideDistX = (mapX + 1.0f - player.position.x) * deltaDistX;
-        }
-        
-        if (rayDirY < 0) {
-            stepY = -1;
-            sideDistY = (player.position.y - mapY) * deltaDistY;
-        } else {
-            stepY = 1;
-            sideDistY = (mapY + 1.0f - player.position.y) * deltaDistY;
-        }
-        
-        // DDA Algorithm
-        int hit = 0;  // Was a wall hit?
-        int side;     // Which side was hit? (NS or EW)
-        CellType hitType = CELL_WALL; // Type of cell that was hit
-        
-        while (hit == 0 && (sideDistX < raycastMaxDistance || sideDistY < raycastMaxDistance)) {
-            // Jump to next map square
-            if (sideDistX < sideDistY) {
-                sideDistX += deltaDistX;
-                mapX += stepX;
-                side = 0;
-            } else {
-                sideDistY += deltaDistY;
-                mapY += stepY;
-                side = 1;
-            }
-            
-    // Check if the ray hit a wall
-    if (mapX >= 0 && mapX < MAZE_WIDTH && mapY >= 0 && mapY < MAZE_HEIGHT) {
-        CellType cellType = GetCellType(&gameMaze, mapX, mapY);
-        if (cellType == CELL_WALL) {
-            hit = 1;
-            hitType = CELL_WALL;
-        } 
-        // else if (cellType == CELL_EXIT) {
-        //     hit = 1;
-        //     hitType = CELL_EXIT;
-        //     }
-            } else {
-                hit = 1;  // Hit map boundary
-            }
-        }
-        
-        // Calculate perpendicular distance to the wall
-        float perpWallDist;
-        if (side == 0) {
-            // Exact distance to the wall in X direction
-            perpWallDist = (mapX - player.position.x + (1 - stepX) / 2) / rayDirX;
-        } else {
-            // Exact distance to the wall in Y direction
-            perpWallDist = (mapY - player.position.y + (1 - stepY) / 2) / rayDirY;
-        }
-        
-        // Store the distance in the z-buffer
-        zBuffer[x] = perpWallDist;
-        
-        // Avoid division by zero
-        if (perpWallDist < 0.1f) perpWallDist = 0.1f;
-        
-        // Calculate height of the line to draw
-        int lineHeight = (int)(screenHeight / perpWallDist);
-        
-        // Calculate start and end points
-        int drawStart = -lineHeight / 2 + screenHeight / 2;
-        if (drawStart < 0) drawStart = 0;
-        
-        int drawEnd = lineHeight / 2 + screenHeight / 2;
-        if (drawEnd >= screenHeight) drawEnd = screenHeight - 1;
-        
-        // Calculate texture x-coordinate
-        float wallX;
-        if (side == 0) {
-            wallX = player.position.y + perpWallDist * rayDirY;
-        } else {
-            wallX = player.position.x + perpWallDist * rayDirX;
-        }
-        wallX -= floor(wallX);
-        
-        // Texture x-coordinate
-        int texX = (int)(wallX * wallTextures[0].width);
-        if ((side == 0 && rayDirX > 0) || (side == 1 && rayDirY < 0)) {
-            texX = wallTextures[0].width - texX - 1;
-        }
+    for (int x = 0; x < columns.width; x++) {
+        int side = columns.side[x];          // Which side was hit? (NS or EW)
+        CellType hitType = CELL_WALL;        // Type of cell that was hit
+        int drawStart = columns.drawStart[x];
+        int drawEnd = columns.drawEnd[x];
 
-        Rectangle srcRect = { (float)texX, 0, 1.0f, (float)wallTextures[0].height };
+        Rectangle srcRect = { (float)columns.texX[x], 0, 1.0f, (float)wallTextures[0]->height };
         Rectangle destRect = { (float)x, (float)drawStart, 1.0f, (float)(drawEnd - drawStart) };
         Vector2 origin = { 0, 0 };
             
-        // Apply shading for N/S walls
-        Color tint = WHITE;
-        if (side == 1) {
-            tint = (Color){ 180, 180, 180, 255 }; // Gray for shading
-        }
+        // Shade by fog and light (N/S walls are darker)
+        int light = world->maze.light[columns.cellY[x]][columns.cellX[x]];
+        Color tint = GetShadeTint(GetShadeLevel(&shadeTable, side, light, columns.depth[x]));
         if(hitType == CELL_EXIT){
-            if (player.keys >= MAX_KEYS) {
+            if (world->keys >= MAX_KEYS) {
                 tint = (Color){ 50, 255, 50, 255 }; // Green for exit
             } else {
                 tint = (Color){ 0, 150, 0, 255 }; // Red for blocked exit
             }
         }
             
-        DrawTexturePro(wallTextures[0], srcRect, destRect, origin, 0.0f, tint);
+        DrawTexturePro(*wallTextures[0], srcRect, destRect, origin, 0.0f, tint);
     }
+    
+    // One textured column per ray plus the floor and ceiling
+    ProfileCount(PROFILE_DRAW_CALLS, columns.width + 4);
 }
 
-static void RenderSprites(float zBuffer[]) {
-    // Calculate camera direction and plane
-    float playerDirX = cosf(player.angle);
-    float playerDirY = sinf(player.angle);
-    float fovHalf = DegToRad(FOV / 2);
-    float planeX = -playerDirY * tanf(fovHalf);
-    float planeY = playerDirX * tanf(fovHalf);
-    
-    // Update the door sprite texture based on its state
-    if (exitDoor.spriteIndex >= 0 && exitDoor.spriteIndex < spriteCount) {
-        sprites[exitDoor.spriteIndex].texture = exitDoor.isOpen ? 
-            exitDoor.openTexture : exitDoor.closedTexture;
-        sprites[exitDoor.spriteIndex].frame = (Rectangle){ 
-            0, 0, 
-            sprites[exitDoor.spriteIndex].texture.width, 
-            sprites[exitDoor.spriteIndex].texture.height 
-        };
-    }
+// Draw the sprites of the snapshot, clipped against the walls
+static void RenderSprites(const WorldSnapshot *world, const float zBuffer[]) {
+    const Sprite *sprites = world->sprites;
+    int spriteCount = world->spriteCount;
+    if (spriteCount <= 0) return;
 
-    // Sort sprites by distance (from farthest to closest)
-    for (int i = 0; i < spriteCount - 1; i++) {
-        for (int j = 0; j < spriteCount - i - 1; j++) {
-            float dist1 = Distance(player.position.x, player.position.y, 
-                                  sprites[j].position.x, sprites[j].position.y);
-            float dist2 = Distance(player.position.x, player.position.y, 
-                                  sprites[j+1].position.x, sprites[j+1].position.y);
-            
-            if (dist1 < dist2) {
-                // Swap sprites
-                Sprite temp = sprites[j];
-                sprites[j] = sprites[j+1];
-                sprites[j+1] = temp;
-                
-                // If it's an enemy, update its sprite index
-                for (int k = 0; k < enemyCount; k++) {
-                    if (enemies[k].spriteIndex == j) {
-                        enemies[k].spriteIndex = j+1;
-                    } else if (enemies[k].spriteIndex == j+1) {
-                        enemies[k].spriteIndex = j;
-                    }
-                }
-                
-                // If it's the exit door, update its index
-                if (exitDoor.spriteIndex == j) {
-                    exitDoor.spriteIndex = j+1;
-                } else if (exitDoor.spriteIndex == j+1) {
-                    exitDoor.spriteIndex = j;
-                }
-            }
-        }
+    // Interpolated positions (between the last two simulation steps) used for sorting and drawing
+    Vector2 *spritePositions = ArenaAlloc(&frameArena, spriteCount * sizeof(Vector2));
+    if (spritePositions == NULL) return;
+    for (int i = 0; i < spriteCount; i++) {
+        spritePositions[i] = LerpVector2(sprites[i].prevPosition, sprites[i].position, world->renderAlpha);
     }
     
-    // Render each sprite
-    for (int i = 0; i < spriteCount; i++) {
-        if (!sprites[i].active) continue;
+    // Sort sprites by distance (from farthest to closest), starting from last frame's order
+    if (spriteOrderCount != spriteCount) {
+        for (int i = 0; i < spriteCount; i++) spriteOrder[i] = i;
+        spriteOrderCount = spriteCount;
+    }
+    SortByDistance(spritePositions, spriteCount, viewCamera.position, spriteOrder);
     
-        // Relative position of sprite to the player
-        float spriteX = sprites[i].position.x - player.position.x;
-        float spriteY = sprites[i].position.y - player.position.y;
+    // Render each sprite
+    for (int n = 0; n < spriteCount; n++) {
+        int i = spriteOrder[n];
     
         // Transform to camera space
-        float invDet = 1.0f / (planeX * playerDirY - playerDirX * planeY);
-        float transformX = invDet * (playerDirY * spriteX - playerDirX * spriteY);
-        float transformY = invDet * (-planeY * spriteX + planeX * spriteY);
-    
-        // If behind camera, don't render
-        if (transformY <= 0) continue;
+        Vector2 transform = TransformToRayCamera(&viewCamera, spritePositions[i]);
+        float transformY = transform.y;
     
-        // Calculate screen position
-        int spriteScreenX = (int)((GetScreenWidth() / 2) * (1 + transformX / transformY));
-    
-        // Calculate sprite height
-        int spriteHeight = abs((int)(GetScreenHeight() / transformY));
-        
-        // Specific adjustments by sprite type
-        if (sprites[i].type == CELL_KEY) {
-            spriteHeight /= 2; // Reduce height by half for keys
-        }
-        else if (sprites[i].type == CELL_EXIT) {
-            spriteHeight = (int)(spriteHeight * 1.3f); // Increase door size by 30%
-        }
-    
-        // Calculate sprite width - use same proportion as height to maintain shape
-        int spriteWidth = spriteHeight;
-        
-        // Calculate drawing coordinates
-        int drawStartY;
-        int drawEndY;
-        
-        if (sprites[i].type == CELL_ENEMY) {
-            // For enemies: standard position, no special adjustments
-            drawStartY = -spriteHeight / 2 + GetScreenHeight() / 2;
-            if (drawStartY < 0) drawStartY = 0;
-            
-            drawEndY = spriteHeight / 2 + GetScreenHeight() / 2 + 100;
-            if (drawEndY >= GetScreenHeight()) drawEndY = GetScreenHeight() - 1;
-        } 
-        else if (sprites[i].type == CELL_EXIT) {
-            // For doors: adjust vertical position to be on the floor
-            drawEndY = GetScreenHeight() / 2 + spriteHeight / 2;
-            if (drawEndY >= GetScreenHeight()) drawEndY = GetScreenHeight() - 1;
-            
-            drawStartY = drawEndY - spriteHeight;
-            if (drawStartY < 0) drawStartY = 0;
-        }
-        else {
-            // For keys: adjust vertical position to float at mid-height
-            drawStartY = -spriteHeight / 2 + GetScreenHeight() / 2;
-            if (drawStartY < 0) drawStartY = 0;
-            
-            drawEndY = spriteHeight / 2 + GetScreenHeight() / 2;
-            if (drawEndY >= GetScreenHeight()) drawEndY = GetScreenHeight() - 1;
-        }
-    
-        int drawStartX = -spriteWidth / 2 + spriteScreenX;
-        if (drawStartX < 0) drawStartX = 0;
-    
-        int drawEndX = spriteWidth / 2 + spriteScreenX;
-        if (drawEndX >= GetScreenWidth()) drawEndX = GetScreenWidth() - 1;
+        // Screen rectangle (skipped if behind the camera)
+        SpriteProjection projection;
+        if (!ProjectSprite(transform, sprites[i].type, GetScreenWidth(), GetScreenHeight(), &projection)) continue;
+
+        // Shade by fog and the light of the sprite's cell (lost in the fog if black)
+        Vector2 cell = WorldToGrid(spritePositions[i]);
+        int light = IsPosInBounds((int)cell.x, (int)cell.y) ? world->maze.light[(int)cell.y][(int)cell.x] : LIGHT_AMBIENT;
+        int shadeLevel = GetShadeLevel(&shadeTable, 0, light, transformY);
+        if (shadeLevel == 0) continue;
+        Color tint = GetShadeTint(shadeLevel);
+
+        int drawStartX = projection.drawStartX;
+        int drawEndX = projection.drawEndX;
+        int drawStartY = projection.drawStartY;
+        int drawEndY = projection.drawEndY;
     
         // Draw the sprite
+        int stripesDrawn = 0;
         for (int stripe = drawStartX; stripe < drawEndX; stripe++) {
             // Only draw if it's closer than a wall
             if (transformY < zBuffer[stripe]) {
+                stripesDrawn++;
+                
                 // Calculate the X coordinate in the texture
-                int texX = (int)((stripe - drawStartX) * sprites[i].texture.width / (drawEndX - drawStartX));
+                int texX = (int)((stripe - drawStartX) * sprites[i].texture->width / (drawEndX - drawStartX));
                 
                 if (texX < 0) texX = 0;
-                if (texX >= sprites[i].texture.width) texX = sprites[i].texture.width - 1;
+                if (texX >= sprites[i].texture->width) texX = sprites[i].texture->width - 1;
                 
                 Rectangle srcRect = (Rectangle){ 
                     (float)texX, 
                     0, 
                     1.0f, 
-                    (float)sprites[i].texture.height 
+                    (float)sprites[i].texture->height 
                 };
                 
                 Rectangle destRect = {
@@ -970,72 +922,94 @@ static void RenderSprites(float zBuffer[]) {
                 };
                 
                 // Use specific color based on sprite type
-                Color tint = WHITE; // Default color
-                
                 if (sprites[i].type == CELL_KEY) {
                     // Keys always with normal color
-                    DrawTexturePro(sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, tint);
+                    DrawTexturePro(*sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, tint);
                 } 
                 else if (sprites[i].type == CELL_ENEMY) {
                     // Enemies always with normal color
-                    DrawTexturePro(sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, tint);
+                    DrawTexturePro(*sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, tint);
                 }
                 else if (sprites[i].type == CELL_EXIT) {
-                    // Door without color change, use WHITE instead of GREEN or any other color
-                    DrawTexturePro(sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, WHITE);
+                    // Door without color change, only the shade instead of GREEN or any other color
+                    DrawTexturePro(*sprites[i].texture, srcRect, destRect, (Vector2){0, 0}, 0, tint);
                 }
             }
         }
+        
+        // One draw call per visible stripe
+        if (stripesDrawn > 0) {
+            ProfileCount(PROFILE_SPRITES_DRAWN, 1);
+            ProfileCount(PROFILE_DRAW_CALLS, stripesDrawn);
+        }
     }
 }
 
+// Render the 3D view: trace every column, shade the walls, then draw the sprites clipped
+// against the wall depths
+static void RenderWorld(const WorldSnapshot *world) {
+    if (!ReserveColumnBuffer(&columns, GetScreenWidth())) {
+        ClearBackground(BLACK);
+        return;
+    }
+    
+    PROFILE_SCOPE(PROFILE_RAYCASTING) {
+        int ddaSteps = TraceColumns(&columns, &world->maze, &viewCamera, (float)GetScreenHeight(),
+                                    wallTextures[0]->width, raycastMaxDistance, CAST_CACHED);
+        ProfileCount(PROFILE_RAYS, columns.width);
+        ProfileCount(PROFILE_DDA_STEPS, ddaSteps);
+    }
+    PROFILE_SCOPE(PROFILE_WALLS) RenderWalls(world);
+    PROFILE_SCOPE(PROFILE_SPRITES) RenderSprites(world, columns.depth);
+}
+
 // Render the user interface (HUD)
-static void RenderHUD(void) {
+static void RenderHUD(const WorldSnapshot *world) {
     // Draw health bar
-    DrawRectangle(10, GetScreenHeight() - 30, player.health * 2, 20, RED);
+    DrawRectangle(10, GetScreenHeight() - 30, world->health * 2, 20, RED);
     DrawRectangleLines(10, GetScreenHeight() - 30, 200, 20, WHITE);
     
     // Show collected keys
-    for (int i = 0; i < player.keys; i++) {
+    for (int i = 0; i < world->keys; i++) {
         DrawRectangle(10 + i * 20, GetScreenHeight() - 55, 15, 15, YELLOW);
     }
+    ProfileCount(PROFILE_DRAW_CALLS, 2 + world->keys);
 
-    if (showExitMessage) {
-        const char* message = TextFormat("You need %d more keys to exit", MAX_KEYS - player.keys);
-        int textWidth = MeasureText(message, 20);
+    if (world->showExitMessage) {
+        // The text only changes with the keys missing, the layer is as wide as the text
+        int keysMissing = MAX_KEYS - world->keys;
+        const char* message = TextFormat("You need %d more keys to exit", keysMissing);
+        int textWidth = (exitMessageLayer.valid && exitMessageLayer.key == (unsigned int)keysMissing) ?
+                        exitMessageLayer.width : MeasureText(message, 20);
+        
+        if (BeginCachedLayer(&exitMessageLayer, textWidth, 20, keysMissing)) {
+            DrawText(message, 0, 0, 20, RED);
+            EndCachedLayer();
+        }
+        
         DrawRectangle(GetScreenWidth()/2 - textWidth/2 - 10, GetScreenHeight()/2 - 15, 
                      textWidth + 20, 30, (Color){0, 0, 0, 200});
-        DrawText(message, GetScreenWidth()/2 - textWidth/2, GetScreenHeight()/2 - 10, 20, RED);
+        DrawCachedLayer(&exitMessageLayer, (Vector2){ (float)(GetScreenWidth()/2 - textWidth/2), (float)(GetScreenHeight()/2 - 10) }, WHITE);
+        ProfileCount(PROFILE_DRAW_CALLS, 2);
     }
     
     // Show weapon with animation
-    if (katanaAnim.frames[0].id == 0) {
+    if (katanaAnim.frames[0]->id == 0) {
         // If textures aren't loaded, show error message
         DrawText("ERROR: Weapon textures not loaded", 10, GetScreenHeight() - 80, 20, RED);
+        ProfileCount(PROFILE_DRAW_CALLS, 1);
         return;
     }
 
-    // Calculate which frame to show based on animation state
-    int frameToShow = 0;
-
-    if (katanaAnim.isSwinging) {
-        // Calculate animation progress (0.0 to 1.0)
-        float progress = 1.0f - (katanaAnim.swingTimer / katanaAnim.swingDuration);
-        
-        // Map progress to the 5 frames (more directly)
-        frameToShow = (int)(progress * 4.99f); // Using 4.99 to ensure it reaches the last frame
-        
-        // Ensure index is within correct range
-        if (frameToShow >= 5) frameToShow = 4;
-        if (frameToShow < 0) frameToShow = 0;
-    } 
+    // Frame chosen by the simulation from the animation state
+    int frameToShow = world->weaponFrame;
 
     // Draw the complete texture directly
     // DO NOT use DrawTexturePro which may cause scaling issues
     DrawTextureEx(
-        katanaAnim.frames[frameToShow], 
-        (Vector2){ GetScreenWidth() - katanaAnim.frames[frameToShow].width * katanaAnim.scale - 400,
-                  GetScreenHeight() - katanaAnim.frames[frameToShow].height * katanaAnim.scale - 200 },
+        *katanaAnim.frames[frameToShow], 
+        (Vector2){ GetScreenWidth() - katanaAnim.frames[frameToShow]->width * katanaAnim.scale - 400,
+                  GetScreenHeight() - katanaAnim.frames[frameToShow]->height * katanaAnim.scale - 200 },
         0.0f,               // Rotation
         katanaAnim.scale * 1.5f,   // Scale
         WHITE               // Color
@@ -1046,111 +1020,56 @@ static void RenderHUD(void) {
              crosshair.position.x + crosshair.size, crosshair.position.y, crosshair.color);
     DrawLine(crosshair.position.x, crosshair.position.y - crosshair.size, 
              crosshair.position.x, crosshair.position.y + crosshair.size, crosshair.color);
+    ProfileCount(PROFILE_DRAW_CALLS, 3); // Weapon and crosshair
 }
 
-// ----------------------------------------------------------------------------------
-// Implementation of Public Functions 
-// ----------------------------------------------------------------------------------
-
-// Initialize the game
-void InitGame(void) {
-    // Set initial state
-    currentState = GAME_TITLE;
+// Store the positions of the current step as the previous ones (interpolation start)
+static void SavePreviousState(void) {
+    player.prevPosition = player.position;
+    player.prevAngle = player.angle;
     
-    // Initialize raycasting variables
-    projPlaneDistance = (GetScreenWidth() / 2.0f) / tanf(DegToRad(FOV / 2.0f));
-    numRays = GetScreenWidth();
-    
-    // Initialize random seed
-    srand(GetTime() * 1000.0f);
-    
-    // Generate maze
-    GenerateMaze(&gameMaze);
-    
-    // Initialize player
-    InitPlayer();
-    
-    // Load textures and sounds
-    wallTextures[0] = LoadTexture("assets/textures/wall.png");
-    weaponTexture = LoadTexture("assets/textures/weapons/tile003.png");
-    keyTexture = LoadTexture("assets/textures/key.png");    
-    exitDoor.openTexture = LoadTexture("assets/textures/door_open.png");
-    exitDoor.closedTexture = LoadTexture("assets/textures/door_closed.png");
-    // Debug check for textures
-    if (keyTexture.id == 0) {
-        printf("ERROR: Failed to load key.png texture\n");
-    } else {
-        printf("Key texture loaded successfully. Width: %d, Height: %d\n", 
-              keyTexture.width, keyTexture.height);
-    }
-    if (exitDoor.openTexture.id == 0) {
-        printf("ERROR: Failed to load door_open.png\n");
-    } else {
-        printf("Door open texture loaded successfully. Width: %d, Height: %d\n", 
-               exitDoor.openTexture.width, exitDoor.openTexture.height);
+    for (int i = 0; i < entities.count[COMPONENT_TRANSFORM]; i++) {
+        entities.transforms[i].prevPosition = entities.transforms[i].position;
     }
-    
-    if (exitDoor.closedTexture.id == 0) {
-        printf("ERROR: Failed to load door_closed.png\n");
-    } else {
-        printf("Door closed texture loaded successfully. Width: %d, Height: %d\n", 
-               exitDoor.closedTexture.width, exitDoor.closedTexture.height);
-    }
-    
-    exitDoor.isOpen = false;
-    exitDoor.active = true;
-    exitDoor.position = GridToWorld((int)gameMaze.exitPos.x, (int)gameMaze.exitPos.y);
-    exitDoor.spriteIndex = -1; // Will be set when we add the sprite
-
-    
-    
-    // Door position (will be updated after initializing the maze)
-    //exitDoor.position = GridToWorld((int)gameMaze.exitPos.x, (int)gameMaze.exitPos.y);
-    
-    // Load individual enemy textures
-    LoadEnemyTextures();
-    
-    // Initialize enemies (this also initializes sprites)
-    InitEnemies();
-    
-    // Load sounds
-    footstepSound = LoadSound("assets/sounds/footsteps.wav");
-    victorySound = LoadSound("assets/sounds/victory.wav");
-    keyPickupSound = LoadSound("assets/sounds/key.wav");
-    playerHitSound = LoadSound("assets/sounds/damage.mp3"); 
-    gameOverSound = LoadSound("assets/sounds/victory.wav"); 
-    shootSound = LoadSound("assets/sounds/shoot.mp3"); 
 }
 
-// Update game logic
-void UpdateGame(void) {
+// Advance the game by one fixed simulation step
+static void StepGame(unsigned int inputDown, unsigned int inputPressed, float deltaTime) {
     switch (currentState) {
         case GAME_TITLE:
-            if (IsKeyPressed(KEY_ENTER)) {
+            // The game can't start until every asset is loaded
+            if (IsAssetLoadComplete() && (inputPressed & INPUT_START)) {
+                InitLevel();
                 currentState = GAME_PLAYING;
             }
             break;
             
         case GAME_PLAYING:
+            // Keep the previous state so rendering can interpolate between steps
+            SavePreviousState();
+            
             // Process player movement
-            MovePlayer();
+            PROFILE_SCOPE(PROFILE_MOVE_PLAYER) MovePlayer(inputDown, deltaTime);
             
             // Update enemies
-            UpdateEnemies();
+            PROFILE_SCOPE(PROFILE_UPDATE_ENEMIES) {
+                UpdateEnemies(deltaTime);
+                UpdateAnimations(deltaTime);
+            }
             
             // Shoot
-            if (IsKeyPressed(KEY_SPACE) && !katanaAnim.isSwinging) {
+            if ((inputPressed & INPUT_SHOOT) && !katanaAnim.isSwinging) {
                 katanaAnim.isSwinging = true;
                 katanaAnim.swingTimer = katanaAnim.swingDuration;
                 katanaAnim.currentFrame = 0;
                 katanaAnim.frameTimer = 0.0f;
                 player.shootCooldown = PLAYER_SHOOT_COOLDOWN;
-                PlaySound(shootSound); // Play shooting sound
+                QueueSound(SOUND_SHOOT); // Play shooting sound
             }
             
             if (katanaAnim.isSwinging) {
-                katanaAnim.swingTimer -= GetFrameTime();
-                katanaAnim.frameTimer += GetFrameTime();
+                katanaAnim.swingTimer -= deltaTime;
+                katanaAnim.frameTimer += deltaTime;
                 
                 // Update animation frame based on progress
                 float progress = 1.0f - (katanaAnim.swingTimer / katanaAnim.swingDuration);
@@ -1158,7 +1077,7 @@ void UpdateGame(void) {
                 if (katanaAnim.currentFrame >= 5) katanaAnim.currentFrame = 4;
                 
                 // Check attacks against enemies
-                CheckPlayerAttacks();
+                PROFILE_SCOPE(PROFILE_PLAYER_ATTACKS) CheckPlayerAttacks();
                 
                 if (katanaAnim.swingTimer <= 0.0f) {
                     katanaAnim.isSwinging = false;
@@ -1168,18 +1087,21 @@ void UpdateGame(void) {
 
             // Update cooldown
             if (player.shootCooldown > 0) {
-                player.shootCooldown -= GetFrameTime();
+                player.shootCooldown -= deltaTime;
             }
             
             // Pause game
-            if (IsKeyPressed(KEY_P)) {
+            if (inputPressed & INPUT_PAUSE) {
                 currentState = GAME_PAUSED;
             }
             break;
             
         case GAME_PAUSED:
+            // Nothing moves while paused, don't interpolate towards the last step
+            SavePreviousState();
+            
             // Return to game
-            if (IsKeyPressed(KEY_P)) {
+            if (inputPressed & INPUT_PAUSE) {
                 currentState = GAME_PLAYING;
             }
             break;
@@ -1187,15 +1109,9 @@ void UpdateGame(void) {
         case GAME_VICTORY:
         case GAME_OVER:
             // Restart game when pressing R
-            if (IsKeyPressed(KEY_R)) {
-                // Regenerate maze
-                GenerateMaze(&gameMaze);
-                
-                // Reset player
-                InitPlayer();
-                
-                // Reset enemies
-                InitEnemies();
+            if (inputPressed & INPUT_RESTART) {
+                // Regenerate maze, player, door and enemies
+                InitLevel();
                 
                 // Return to game state
                 currentState = GAME_PLAYING;
@@ -1204,258 +1120,632 @@ void UpdateGame(void) {
     }
 }
 
+// Copy the state the renderer needs into the next snapshot and publish it (simulation side)
+static void PublishSnapshot(void) {
+    WorldSnapshot *snapshot = &snapshots[GetTripleBufferBack(&snapshotBuffer)];
+    
+    snapshot->state = currentState;
+    snapshot->maze = gameMaze;
+    snapshot->playerPosition = player.position;
+    snapshot->playerPrevPosition = player.prevPosition;
+    snapshot->playerAngle = player.angle;
+    snapshot->playerPrevAngle = player.prevAngle;
+    snapshot->renderAlpha = renderAlpha;
+    snapshot->health = player.health;
+    snapshot->keys = player.keys;
+    snapshot->showExitMessage = showExitMessage;
+    
+    // Weapon frame from the animation progress
+    snapshot->weaponFrame = 0;
+    if (katanaAnim.isSwinging) {
+        // Calculate animation progress (0.0 to 1.0)
+        float progress = 1.0f - (katanaAnim.swingTimer / katanaAnim.swingDuration);
+        
+        // Map progress to the 5 frames (more directly)
+        int frame = (int)(progress * 4.99f); // Using 4.99 to ensure it reaches the last frame
+        
+        // Ensure index is within correct range
+        if (frame >= 5) frame = 4;
+        if (frame < 0) frame = 0;
+        snapshot->weaponFrame = frame;
+    }
+    
+    // One sprite per render component
+    int spriteCount = entities.count[COMPONENT_RENDER];
+    if (spriteCount > MAX_SPRITES) spriteCount = MAX_SPRITES;
+    
+    for (int i = 0; i < spriteCount; i++) {
+        EntityHandle entity = GetComponentOwner(&entities, COMPONENT_RENDER, i);
+        const TransformComponent *transform = GetComponent(&entities, entity, COMPONENT_TRANSFORM);
+        
+        snapshot->sprites[i].position = transform->position;
+        snapshot->sprites[i].prevPosition = transform->prevPosition;
+        snapshot->sprites[i].texture = entities.renders[i].texture;
+        snapshot->sprites[i].type = entities.renders[i].type;
+    }
+    snapshot->spriteCount = spriteCount;
+    
+    PublishTripleBuffer(&snapshotBuffer);
+}
+
+// Compute the interpolated camera used to render this frame
+static void UpdateView(const WorldSnapshot *world) {
+    Vector2 viewPosition = LerpVector2(world->playerPrevPosition, world->playerPosition, world->renderAlpha);
+    
+    // Interpolate the angle along the shortest arc
+    float angleDelta = world->playerAngle - world->playerPrevAngle;
+    if (angleDelta > PI) angleDelta -= 2.0f * PI;
+    if (angleDelta < -PI) angleDelta += 2.0f * PI;
+    float viewAngle = NormalizeAngle(world->playerPrevAngle + angleDelta * world->renderAlpha);
+    
+    // Direction, plane and inverse determinant, shared by every pass of the frame
+    viewCamera = MakeRayCamera(viewPosition, viewAngle, cameraPlaneScale);
+}
+
+// Run the simulation steps covered by one frame of input
+static void SimulateInput(GameInput input) {
+    // Pressed actions are kept until a step consumes them, even if this frame runs no step
+    pendingPressed |= input.pressed;
+    simAccumulator += input.deltaTime;
+    
+    // On slow machines drop the time we can't catch up with instead of piling up steps
+    if (simAccumulator > MAX_SIM_STEPS * SIM_DT) {
+        simAccumulator = MAX_SIM_STEPS * SIM_DT;
+    }
+    
+    while (simAccumulator >= SIM_DT) {
+        TRACE_SCOPE("Step") StepGame(input.down, pendingPressed, SIM_DT);
+        pendingPressed = 0;
+        gameTicks++;
+        simAccumulator -= SIM_DT;
+    }
+    
+    renderAlpha = simAccumulator / SIM_DT;
+}
+
+// Hand the input of a frame to the simulation thread (waits if it is PIPELINE_INPUT_FRAMES behind)
+static void PushInput(GameInput input) {
+    pthread_mutex_lock(&inputMutex);
+    
+    if (inputCount == PIPELINE_INPUT_FRAMES) {
+        TraceBegin("Wait for simulation");
+        while (inputCount == PIPELINE_INPUT_FRAMES) pthread_cond_wait(&inputFree, &inputMutex);
+        TraceEnd("Wait for simulation");
+    }
+    
+    inputQueue[(inputHead + inputCount) % PIPELINE_INPUT_FRAMES] = input;
+    inputCount++;
+    pthread_cond_signal(&inputReady);
+    pthread_mutex_unlock(&inputMutex);
+}
+
+// Take the input of the next frame (simulation thread), returns false once asked to stop and
+// every queued frame has been simulated
+static bool PopInput(GameInput *input) {
+    pthread_mutex_lock(&inputMutex);
+    
+    while (inputCount == 0 && !simStopRequested) pthread_cond_wait(&inputReady, &inputMutex);
+    
+    bool available = (inputCount > 0);
+    if (available) {
+        *input = inputQueue[inputHead];
+        inputHead = (inputHead + 1) % PIPELINE_INPUT_FRAMES;
+        inputCount--;
+        pthread_cond_signal(&inputFree);
+    }
+    
+    pthread_mutex_unlock(&inputMutex);
+    return available;
+}
+
+// Simulation thread: steps the game with every frame of input and publishes a snapshot
+static void *SimulationThread(void *arg) {
+    TraceSetThreadName("Simulation");
+    
+    GameInput input;
+    while (PopInput(&input)) {
+        SimulateInput(input);
+        PublishSnapshot();
+    }
+    
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions 
+// ----------------------------------------------------------------------------------
+
+// Initialize the game
+void InitGame(void) {
+    // Set initial state
+    currentState = GAME_TITLE;
+    
+    // Initialize raycasting variables
+    InitFastMath();
+    cameraPlaneScale = tanf(DegToRad(FOV / 2.0f));
+    BuildShadeTable(&shadeTable, FOG_START, FOG_END);
+    projPlaneDistance = (GetScreenWidth() / 2.0f) / cameraPlaneScale;
+    numRays = GetScreenWidth();
+    
+    // Initialize random seed
+    unsigned int seed = (gameSeed != 0) ? gameSeed : (unsigned int)(GetTime() * 1000.0f);
+    srand(seed);
+    gameTicks = 0;
+    simAccumulator = 0.0f;
+    pendingPressed = 0;
+    
+    // Generate the upcoming levels on a background thread
+    StartLevelPool(seed);
+    
+    // Headless runs only simulate: no asset is ever loaded
+    if (headlessMode) {
+        BindNullAssets();
+        return;
+    }
+    
+    InitHUD();
+    InitArena(&frameArena, FRAME_ARENA_SIZE);
+    
+    // The title screen is drawn from the first snapshot
+    InitTripleBuffer(&snapshotBuffer);
+    PublishSnapshot();
+    
+    // From here on only the simulation thread touches the game state (and publishes snapshots)
+    if (pipelinedMode) {
+        simStopRequested = false;
+        inputHead = 0;
+        inputCount = 0;
+        if (pthread_create(&simThread, NULL, SimulationThread, NULL) == 0) {
+            simRunning = true;
+        } else {
+            printf("Error starting simulation thread, the game will run sequentially\n");
+        }
+    }
+    
+    // Map the asset archive if it was built (loose files are used otherwise)
+    OpenAssetPack(ASSET_PACK_FILE);
+    
+    // Read and decode every asset on a worker thread, the title screen shows the progress
+    // and the first level is created once everything has been uploaded
+    TRACE_SCOPE("Queue assets") {
+        AcquireGlobalAssets();
+        AcquireLevelAssets(&levelAssets);
+        StartAssetLoader();
+    }
+}
+
+// Update game logic
+void UpdateGame(void) {
+    // Upload assets decoded by the loader thread, nothing is simulated until they are all
+    // loaded so any input stream (keyboard, replay or bot) starts at the same point of the game
+    if (!IsAssetLoadComplete()) {
+        TRACE_SCOPE("Upload assets") UpdateAssetLoader(ASSET_UPLOAD_BUDGET);
+        if (!IsAssetLoadComplete()) return;
+    }
+    
+    GameInput input = (inputSource != NULL) ? inputSource() : PollGameInput();
+    
+    if (simRunning) {
+        // The simulation thread runs the steps while this frame is rendered
+        PushInput(input);
+    } else {
+        SimulateInput(input);
+        if (!headlessMode) PublishSnapshot();
+    }
+    
+    PlayQueuedSounds();
+}
+
+// Static part of the title screen (cached, see RenderGame)
+static void DrawTitleScreen(void) {
+    // Clean black background
+    ClearBackground(BLACK);
+    
+    // Game title - larger and more prominent
+    DrawText("MazeRay", 
+             GetScreenWidth()/2 - MeasureText("MazeRay", 60)/2, 
+             GetScreenHeight()/6, 
+             60, RED);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/4, 
+        GetScreenHeight()/6 + 80, 
+        GetScreenWidth()*3/4, 
+        GetScreenHeight()/6 + 80, 
+        (Color){100, 100, 100, 255});
+    
+    // Game description - more detailed and centered
+    DrawText("OBJECTIVE:", 
+             GetScreenWidth()/2 - MeasureText("OBJECTIVE:", 25)/2, 
+             GetScreenHeight()/6 + 100, 
+             25, YELLOW);
+             
+    DrawText("Navigate through a dangerous maze filled with enemies", 
+             GetScreenWidth()/2 - MeasureText("Navigate through a dangerous maze filled with enemies", 18)/2, 
+             GetScreenHeight()/6 + 135, 
+             18, WHITE);
+             
+    DrawText("Find all 3 keys to unlock the exit", 
+             GetScreenWidth()/2 - MeasureText("Find all 3 keys to unlock the exit", 18)/2, 
+             GetScreenHeight()/6 + 160, 
+             18, WHITE);
+             
+    DrawText("Fight enemies with your 9mm to survive", 
+             GetScreenWidth()/2 - MeasureText("Fight enemies with your 9mm to survive", 18)/2, 
+             GetScreenHeight()/6 + 185, 
+             18, WHITE);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/4, 
+        GetScreenHeight()/2, 
+        GetScreenWidth()*3/4, 
+        GetScreenHeight()/2, 
+        (Color){100, 100, 100, 255});
+    
+    // Controls - Title
+    DrawText("CONTROLS:", 
+             GetScreenWidth()/2 - MeasureText("CONTROLS:", 25)/2,
+             GetScreenHeight()/2 + 30, 
+             25, YELLOW);
+    
+    // Controls - Movement
+    DrawText("WASD / Arrow Keys - Move", 
+             GetScreenWidth()/2 - MeasureText("WASD / Arrow Keys - Move", 18)/2,
+             GetScreenHeight()/2 + 65, 
+             18, LIGHTGRAY);
+    
+    // Controls - Attack
+    DrawText("SPACE - Shoot", 
+             GetScreenWidth()/2 - MeasureText("SPACE - Shoot", 18)/2,
+             GetScreenHeight()/2 + 95, 
+             18, LIGHTGRAY);
+    
+    // Controls - Pause
+    DrawText("P - Pause Game", 
+             GetScreenWidth()/2 - MeasureText("P - Pause Game", 18)/2,
+             GetScreenHeight()/2 + 125, 
+             18, LIGHTGRAY);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/3, 
+        GetScreenHeight()*3/4, 
+        GetScreenWidth()*2/3, 
+        GetScreenHeight()*3/4, 
+        (Color){100, 100, 100, 255});
+}
+
+// Static part of the victory screen (cached, see RenderGame)
+static void DrawVictoryScreen(void) {
+    // Improved victory screen
+    ClearBackground(BLACK);
+    
+    // Victory title - larger and eye-catching
+    DrawText("VICTORY!", 
+             GetScreenWidth()/2 - MeasureText("VICTORY!", 60)/2, 
+             GetScreenHeight()/4, 
+             60, GREEN);
+    
+    // Congratulation message
+    DrawText("Congratulations! You escaped from the maze", 
+             GetScreenWidth()/2 - MeasureText("Congratulations! You escaped from the maze", 20)/2, 
+             GetScreenHeight()/4 + 70, 
+             20, RAYWHITE);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/4, 
+        GetScreenHeight()/2, 
+        GetScreenWidth()*3/4, 
+        GetScreenHeight()/2, 
+        (Color){100, 100, 100, 255});
+    
+    // Thank you message
+    DrawText("Thanks for playing MazeRay!", 
+             GetScreenWidth()/2 - MeasureText("Thanks for playing MazeRay!", 24)/2, 
+             GetScreenHeight()/2 + 30, 
+             24, YELLOW);
+    
+    // Credits or additional information
+    DrawText("A raylib game created by Jorge Carrascosa", 
+             GetScreenWidth()/2 - MeasureText("A raylib game created by Jorge Carrascosa", 18)/2, 
+             GetScreenHeight()/2 + 65, 
+             18, GRAY);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/3, 
+        GetScreenHeight()*3/4 - 30, 
+        GetScreenWidth()*2/3, 
+        GetScreenHeight()*3/4 - 30, 
+        (Color){100, 100, 100, 255});
+}
+
+// Static part of the game over screen (cached, see RenderGame)
+static void DrawGameOverScreen(void) {
+    // Improved defeat screen
+    ClearBackground(BLACK);
+    
+    // Main title - larger and dramatic
+    DrawText("GAME OVER", 
+             GetScreenWidth()/2 - MeasureText("GAME OVER", 60)/2, 
+             GetScreenHeight()/4, 
+             60, RED);
+    
+    // Message detailing the cause of death
+    DrawText("YOU WERE KILLED BY ENEMIES!", 
+             GetScreenWidth()/2 - MeasureText("YOU WERE KILLED BY ENEMIES!", 24)/2, 
+             GetScreenHeight()/4 + 70, 
+             24, RAYWHITE);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/4, 
+        GetScreenHeight()/2, 
+        GetScreenWidth()*3/4, 
+        GetScreenHeight()/2, 
+        (Color){100, 100, 100, 255});
+    
+    // Statistics or motivational message
+    DrawText("The maze remains unconquered...", 
+             GetScreenWidth()/2 - MeasureText("The maze remains unconquered...", 18)/2, 
+             GetScreenHeight()/2 + 30, 
+             18, GRAY);
+    
+    // Separator line
+    DrawLine(
+        GetScreenWidth()/3, 
+        GetScreenHeight()*3/4 - 30, 
+        GetScreenWidth()*2/3, 
+        GetScreenHeight()*3/4 - 30, 
+        (Color){100, 100, 100, 255});
+}
+
+// Blinking instruction line of the static screens: the text is rendered once and the pulse is
+// applied as the tint of the blit
+static void DrawPulsingPrompt(GameState screen, const char *text, int y, Color color) {
+    if (BeginCachedLayer(&promptLayer, GetScreenWidth(), 24, screen)) {
+        DrawText(text, GetScreenWidth()/2 - MeasureText(text, 24)/2, 0, 24, color);
+        EndCachedLayer();
+    }
+    
+    float pulse = sinf(GetTime() * 4) * 0.5f + 0.5f;
+    DrawCachedLayer(&promptLayer, (Vector2){ 0, (float)y }, ColorAlpha(WHITE, 0.5f + 0.5f * pulse));
+}
+
 // Render the game
 void RenderGame(void) {
+    // Draw the latest world published by the simulation (the previous one if nothing new)
+    AcquireTripleBuffer(&snapshotBuffer);
+    const WorldSnapshot *world = &snapshots[GetTripleBufferFront(&snapshotBuffer)];
+    
+    UpdateView(world);
+    ResetArena(&frameArena);
+    
+    // A new pause shows a new frame
+    if (world->state == GAME_PAUSED && lastRenderedState != GAME_PAUSED) InvalidateCachedLayer(&pausedLayer);
+    lastRenderedState = world->state;
+    
     BeginDrawing();
     
-    switch (currentState) {
+    switch (world->state) {
         case GAME_TITLE:
-        // Clean black background
-        ClearBackground(BLACK);
-        
-        // Game title - larger and more prominent
-        DrawText("MazeRay", 
-                 GetScreenWidth()/2 - MeasureText("MazeRay", 60)/2, 
-                 GetScreenHeight()/6, 
-                 60, RED);
-        
-        // Separator line
-        DrawLine(
-            GetScreenWidth()/4, 
-            GetScreenHeight()/6 + 80, 
-            GetScreenWidth()*3/4, 
-            GetScreenHeight()/6 + 80, 
-            (Color){100, 100, 100, 255});
-        
-        // Game description - more detailed and centered
-        DrawText("OBJECTIVE:", 
-                 GetScreenWidth()/2 - MeasureText("OBJECTIVE:", 25)/2, 
-                 GetScreenHeight()/6 + 100, 
-                 25, YELLOW);
-                 
-        DrawText("Navigate through a dangerous maze filled with enemies", 
-                 GetScreenWidth()/2 - MeasureText("Navigate through a dangerous maze filled with enemies", 18)/2, 
-                 GetScreenHeight()/6 + 135, 
-                 18, WHITE);
-                 
-        DrawText("Find all 3 keys to unlock the exit", 
-                 GetScreenWidth()/2 - MeasureText("Find all 3 keys to unlock the exit", 18)/2, 
-                 GetScreenHeight()/6 + 160, 
-                 18, WHITE);
-                 
-        DrawText("Fight enemies with your 9mm to survive", 
-                 GetScreenWidth()/2 - MeasureText("Fight enemies with your 9mm to survive", 18)/2, 
-                 GetScreenHeight()/6 + 185, 
-                 18, WHITE);
-        
-        // Separator line
-        DrawLine(
-            GetScreenWidth()/4, 
-            GetScreenHeight()/2, 
-            GetScreenWidth()*3/4, 
-            GetScreenHeight()/2, 
-            (Color){100, 100, 100, 255});
-        
-        // Controls - Title
-        DrawText("CONTROLS:", 
-                 GetScreenWidth()/2 - MeasureText("CONTROLS:", 25)/2,
-                 GetScreenHeight()/2 + 30, 
-                 25, YELLOW);
-        
-        // Controls - Movement
-        DrawText("WASD / Arrow Keys - Move", 
-                 GetScreenWidth()/2 - MeasureText("WASD / Arrow Keys - Move", 18)/2,
-                 GetScreenHeight()/2 + 65, 
-                 18, LIGHTGRAY);
-        
-        // Controls - Attack
-        DrawText("SPACE - Shoot", 
-                 GetScreenWidth()/2 - MeasureText("SPACE - Shoot", 18)/2,
-                 GetScreenHeight()/2 + 95, 
-                 18, LIGHTGRAY);
-        
-        // Controls - Pause
-        DrawText("P - Pause Game", 
-                 GetScreenWidth()/2 - MeasureText("P - Pause Game", 18)/2,
-                 GetScreenHeight()/2 + 125, 
-                 18, LIGHTGRAY);
-        
-        // Separator line
-        DrawLine(
-            GetScreenWidth()/3, 
-            GetScreenHeight()*3/4, 
-            GetScreenWidth()*2/3, 
-            GetScreenHeight()*3/4, 
-            (Color){100, 100, 100, 255});
-        
-        // Instruction to start - more visible with animation
-        float pulse = sinf(GetTime() * 4) * 0.5f + 0.5f;
-        Color startColor = ColorAlpha(GREEN, 0.5f + 0.5f * pulse);
-        
-        DrawText("Press ENTER to start", 
-                 GetScreenWidth()/2 - MeasureText("Press ENTER to start", 24)/2,
-                 GetScreenHeight()*3/4 + 30, 
-                 24, startColor);
-        
-        break;
+            if (BeginCachedLayer(&screenLayer, GetScreenWidth(), GetScreenHeight(), GAME_TITLE)) {
+                DrawTitleScreen();
+                EndCachedLayer();
+            }
+            DrawCachedLayer(&screenLayer, (Vector2){ 0, 0 }, WHITE);
             
-        case GAME_PLAYING:
-            {
-                // Create z-buffer
-                float zBuffer[GetScreenWidth()];
-                
-                // Render 3D view
-                RenderRaycasting(zBuffer);
-                RenderSprites(zBuffer);
+            if (!IsAssetLoadComplete()) {
+                // Loading progress bar
+                int barWidth = GetScreenWidth()/3;
+                int barX = GetScreenWidth()/2 - barWidth/2;
+                int barY = GetScreenHeight()*3/4 + 30;
                 
-                // Render HUD
-                RenderHUD();
+                DrawRectangle(barX, barY, (int)(barWidth * GetAssetLoadProgress()), 20, DARKGREEN);
+                DrawRectangleLines(barX, barY, barWidth, 20, (Color){100, 100, 100, 255});
+                DrawText("Loading...", 
+                         GetScreenWidth()/2 - MeasureText("Loading...", 18)/2,
+                         barY + 30, 
+                         18, LIGHTGRAY);
+                break;
             }
-            break;
             
-        case GAME_PAUSED:
-            // Show pause screen over the game
-            {
-                float zBuffer[GetScreenWidth()];
-                RenderRaycasting(zBuffer);
-                DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), (Color){0, 0, 0, 150});
-                DrawText("PAUSED", GetScreenWidth()/2 - MeasureText("PAUSED", 40)/2, GetScreenHeight()/2 - 40, 40, WHITE);
-                DrawText("Press P to continue", GetScreenWidth()/2 - MeasureText("Press P to continue", 20)/2, GetScreenHeight()/2 + 10, 20, LIGHTGRAY);
-            }
+            // Instruction to start - more visible with animation
+            DrawPulsingPrompt(GAME_TITLE, "Press ENTER to start", GetScreenHeight()*3/4 + 30, GREEN);
             break;
             
-            case GAME_VICTORY:
-            // Improved victory screen
-            ClearBackground(BLACK);
-            
-            // Victory title - larger and eye-catching
-            DrawText("VICTORY!", 
-                     GetScreenWidth()/2 - MeasureText("VICTORY!", 60)/2, 
-                     GetScreenHeight()/4, 
-                     60, GREEN);
-            
-            // Congratulation message
-            DrawText("Congratulations! You escaped from the maze", 
-                     GetScreenWidth()/2 - MeasureText("Congratulations! You escaped from the maze", 20)/2, 
-                     GetScreenHeight()/4 + 70, 
-                     20, RAYWHITE);
-            
-            // Separator line
-            DrawLine(
-                GetScreenWidth()/4, 
-                GetScreenHeight()/2, 
-                GetScreenWidth()*3/4, 
-                GetScreenHeight()/2, 
-                (Color){100, 100, 100, 255});
-            
-            // Thank you message
-            DrawText("Thanks for playing MazeRay!", 
-                     GetScreenWidth()/2 - MeasureText("Thanks for playing MazeRay!", 24)/2, 
-                     GetScreenHeight()/2 + 30, 
-                     24, YELLOW);
-            
-            // Credits or additional information
-            DrawText("A raylib game created by Jorge Carrascosa", 
-                     GetScreenWidth()/2 - MeasureText("A raylib game created by Jorge Carrascosa", 18)/2, 
-                     GetScreenHeight()/2 + 65, 
-                     18, GRAY);
-            
-            // Separator line
-            DrawLine(
-                GetScreenWidth()/3, 
-                GetScreenHeight()*3/4 - 30, 
-                GetScreenWidth()*2/3, 
-                GetScreenHeight()*3/4 - 30, 
-                (Color){100, 100, 100, 255});
-            
-            // Instruction to retry with pulsing effect
-            float pulseVictory = sinf(GetTime() * 4) * 0.5f + 0.5f;
-            Color victoryRestartColor = ColorAlpha(WHITE, 0.5f + 0.5f * pulseVictory);
+        case GAME_PLAYING:
+            // Render 3D view
+            RenderWorld(world);
             
-            DrawText("Press R to play again", 
-                     GetScreenWidth()/2 - MeasureText("Press R to play again", 24)/2, 
-                     GetScreenHeight()*3/4, 
-                     24, victoryRestartColor);
+            // Render HUD
+            PROFILE_SCOPE(PROFILE_HUD) RenderHUD(world);
             break;
             
-            case GAME_OVER:
-            // Improved defeat screen
+        case GAME_PAUSED:
+            // Show pause screen over the last gameplay frame, the world doesn't move while paused
+            if (BeginCachedLayer(&pausedLayer, GetScreenWidth(), GetScreenHeight(), 0)) {
+                RenderWorld(world);
+                EndCachedLayer();
+            }
             ClearBackground(BLACK);
+            DrawCachedLayer(&pausedLayer, (Vector2){ 0, 0 }, WHITE);
             
-            // Main title - larger and dramatic
-            DrawText("GAME OVER", 
-                     GetScreenWidth()/2 - MeasureText("GAME OVER", 60)/2, 
-                     GetScreenHeight()/4, 
-                     60, RED);
+            // Translucent overlays are drawn directly: blended into a render target they would
+            // leave its alpha below 255 and darken when blitted
+            DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), (Color){0, 0, 0, 150});
             
-            // Message detailing the cause of death
-            DrawText("YOU WERE KILLED BY ENEMIES!", 
-                     GetScreenWidth()/2 - MeasureText("YOU WERE KILLED BY ENEMIES!", 24)/2, 
-                     GetScreenHeight()/4 + 70, 
-                     24, RAYWHITE);
+            if (BeginCachedLayer(&pauseTextLayer, GetScreenWidth(), 70, GAME_PAUSED)) {
+                DrawText("PAUSED", GetScreenWidth()/2 - MeasureText("PAUSED", 40)/2, 0, 40, WHITE);
+                DrawText("Press P to continue", GetScreenWidth()/2 - MeasureText("Press P to continue", 20)/2, 50, 20, LIGHTGRAY);
+                EndCachedLayer();
+            }
+            DrawCachedLayer(&pauseTextLayer, (Vector2){ 0, (float)(GetScreenHeight()/2 - 40) }, WHITE);
+            break;
             
-            // Separator line
-            DrawLine(
-                GetScreenWidth()/4, 
-                GetScreenHeight()/2, 
-                GetScreenWidth()*3/4, 
-                GetScreenHeight()/2, 
-                (Color){100, 100, 100, 255});
+        case GAME_VICTORY:
+            if (BeginCachedLayer(&screenLayer, GetScreenWidth(), GetScreenHeight(), GAME_VICTORY)) {
+                DrawVictoryScreen();
+                EndCachedLayer();
+            }
+            DrawCachedLayer(&screenLayer, (Vector2){ 0, 0 }, WHITE);
             
-            // Statistics or motivational message
-            DrawText("The maze remains unconquered...", 
-                     GetScreenWidth()/2 - MeasureText("The maze remains unconquered...", 18)/2, 
-                     GetScreenHeight()/2 + 30, 
-                     18, GRAY);
+            // Instruction to retry with pulsing effect
+            DrawPulsingPrompt(GAME_VICTORY, "Press R to play again", GetScreenHeight()*3/4, WHITE);
+            break;
             
-            // Separator line
-            DrawLine(
-                GetScreenWidth()/3, 
-                GetScreenHeight()*3/4 - 30, 
-                GetScreenWidth()*2/3, 
-                GetScreenHeight()*3/4 - 30, 
-                (Color){100, 100, 100, 255});
+        case GAME_OVER:
+            if (BeginCachedLayer(&screenLayer, GetScreenWidth(), GetScreenHeight(), GAME_OVER)) {
+                DrawGameOverScreen();
+                EndCachedLayer();
+            }
+            DrawCachedLayer(&screenLayer, (Vector2){ 0, 0 }, WHITE);
             
             // Instruction to retry with pulsing effect
-            float pulseGameOver = sinf(GetTime() * 4) * 0.5f + 0.5f;
-            Color restartColor = ColorAlpha(WHITE, 0.5f + 0.5f * pulseGameOver);
-            
-            DrawText("Press R to try again", 
-                     GetScreenWidth()/2 - MeasureText("Press R to try again", 24)/2, 
-                     GetScreenHeight()*3/4, 
-                     24, restartColor);
+            DrawPulsingPrompt(GAME_OVER, "Press R to try again", GetScreenHeight()*3/4, WHITE);
             break;
     }
     
-    EndDrawing();
+    DrawProfilerOverlay();
+    
+    PROFILE_SCOPE(PROFILE_END_DRAWING) EndDrawing();
 }
 
 // Free resources
 void CloseGame(void) {
-    // Unload textures
-    UnloadTexture(wallTextures[0]);
-    UnloadTexture(weaponTexture);
-    UnloadTexture(keyTexture);
-    
-    // Unload weapon frame textures
-    for (int i = 0; i < 5; i++) {
-        UnloadTexture(katanaAnim.frames[i]);
+    // Stop the simulation thread first, it uses the level and the assets
+    if (simRunning) {
+        pthread_mutex_lock(&inputMutex);
+        simStopRequested = true;
+        pthread_cond_signal(&inputReady);
+        pthread_mutex_unlock(&inputMutex);
+        
+        pthread_join(simThread, NULL);
+        simRunning = false;
     }
     
-    // Unload individual enemy textures
-    for (int i = 0; i < 56; i++) {
-        UnloadTexture(impTextures[i]);
-    }
+    // Stop the loader thread (assets still pending are discarded)
+    StopAssetLoader();
+    
+    // Unload every texture and sound
+    ReleaseAssetScope(&levelAssets);
+    ReleaseAssetScope(&globalAssets);
+    UnloadAssetCache();
+    
+    // Free the cached render targets
+    UnloadCachedLayer(&screenLayer);
+    UnloadCachedLayer(&promptLayer);
+    UnloadCachedLayer(&pausedLayer);
+    UnloadCachedLayer(&pauseTextLayer);
+    UnloadCachedLayer(&exitMessageLayer);
+    
+    // Report and free the frame scratch memory
+    ReportArena(&frameArena, "Frame");
+    FreeArena(&frameArena);
+    FreeColumnBuffer(&columns);
     
-    // Unload door textures
-    UnloadTexture(exitDoor.openTexture);
-    UnloadTexture(exitDoor.closedTexture);
-    
-    // Unload sounds
-    UnloadSound(footstepSound);
-    UnloadSound(victorySound);
-    UnloadSound(keyPickupSound);
-    UnloadSound(playerHitSound);
-    UnloadSound(gameOverSound);
-    UnloadSound(shootSound); // Unload the new shooting sound
+    // Give back the current level and stop the level generator
+    ReleaseLevel(currentLevel);
+    currentLevel = NULL;
+    StopLevelPool();
+    
+    // Unmap the asset archive
+    CloseAssetPack();
+}
+
+// Read input from a custom source
+void SetGameInputSource(GameInputSource source) {
+    inputSource = source;
+}
+
+// Run without window, GPU or audio
+void SetGameHeadless(bool headless) {
+    headlessMode = headless;
+}
+
+// Run the simulation on its own thread
+void SetGamePipelined(bool pipelined) {
+    pipelinedMode = pipelined;
+}
+
+// Seed used for levels and enemy behaviour
+void SetGameSeed(unsigned int seed) {
+    gameSeed = seed;
+}
+
+// Current game state
+GameState GetGameState(void) {
+    return currentState;
+}
+
+// Number of simulation steps run since InitGame
+unsigned int GetGameTicks(void) {
+    return gameTicks;
+}
+
+// Read the keyboard into a GameInput
+GameInput PollGameInput(void) {
+    GameInput input = { 0 };
+    
+    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W)) input.down |= INPUT_FORWARD;
+    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) input.down |= INPUT_BACKWARD;
+    if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) input.down |= INPUT_TURN_LEFT;
+    if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) input.down |= INPUT_TURN_RIGHT;
+    if (IsKeyDown(KEY_SPACE)) input.down |= INPUT_SHOOT;
+    
+    if (IsKeyPressed(KEY_SPACE)) input.pressed |= INPUT_SHOOT;
+    if (IsKeyPressed(KEY_P)) input.pressed |= INPUT_PAUSE;
+    if (IsKeyPressed(KEY_ENTER)) input.pressed |= INPUT_START;
+    if (IsKeyPressed(KEY_R)) input.pressed |= INPUT_RESTART;
+    
+    input.deltaTime = GetFrameTime();
+    
+    return input;
+}
+
+#if defined(MAZERAY_BENCH)
+// Level state saved by BenchStartLevel
+static Player benchPlayer;
+static EntityStore benchEntities;
+static unsigned int benchSeed;
+
+// Start a headless game on its first level and save the level state
+void BenchStartLevel(unsigned int seed) {
+    SetGameHeadless(true);
+    SetGameSeed(seed);
+    InitGame();
+    InitLevel();
+    currentState = GAME_PLAYING;
+    
+    benchPlayer = player;
+    benchEntities = entities;
+    benchSeed = seed;
+}
+
+// Restore the level state saved by BenchStartLevel (every repetition runs the same workload)
+void BenchRestoreLevel(void) {
+    player = benchPlayer;
+    entities = benchEntities;
+    currentState = GAME_PLAYING;
+    srand(benchSeed);
+}
+
+// Run the enemy update of one simulation step
+void BenchUpdateEnemies(float deltaTime) {
+    UpdateEnemies(deltaTime);
+    UpdateAnimations(deltaTime);
+}
+
+// Check a position against the walls of the current level
+bool BenchCheckWallCollision(Vector2 position) {
+    return CheckWallCollision(position);
+}
+
+// Maze of the current level
+const Maze *BenchGetMaze(void) {
+    return &gameMaze;
 }
+#endif
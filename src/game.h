@@ -3,6 +3,7 @@
 
 #include "raylib.h"
 #include "maze.h"
+#include "entity.h"
 
 // Game definitions
 #define FOV             60.0f    // Field of view in degrees
@@ -15,6 +16,13 @@
 #define WALL_SCALE_FACTOR 1.2f    // Adjust to change vertical scaling of walls (increased from 1.0f)
 #define TEXTURE_SCALING_QUALITY 1  // 0 = faster, 1 = better quality
 
+// Fixed timestep simulation
+#define SIM_TICK_RATE       60       // Simulation steps per second
+#define SIM_DT              (1.0f / SIM_TICK_RATE) // Duration of one simulation step
+#define MAX_SIM_STEPS       5        // Steps per frame before the game slows down instead of catching up
+#define PIPELINE_INPUT_FRAMES 2      // Frames the renderer may run ahead of the simulation thread (pipelined mode)
+#define FRAME_ARENA_SIZE    (256 * 1024) // Scratch memory for the temporaries of one rendered frame
+
 // New definitions for enemies
 #define ENEMY_SPEED     0.5f     // Enemy movement speed
 #define ENEMY_ATTACK_RANGE 1.0f  // Distance at which the enemy can attack
@@ -36,9 +44,6 @@
 #define WEAPON_FRAMES       5    // Number of frames in weapon animation
 #define WEAPON_FRAME_TIME   0.05f // Time between frames in weapon animation
 
-// Add the definition of shooting sound after other sound definitions
-static Sound shootSound;          // Shooting sound
-
 // Add a structure for the crosshair
 typedef struct {
     Vector2 position;    // Screen position
@@ -46,22 +51,15 @@ typedef struct {
     Color color;         // Crosshair color
 } Crosshair;
 
-// Add the declaration of the crosshair as a global variable
-static Crosshair crosshair;
-
 // Structure for the exit door
 typedef struct {
-    Vector2 position;    // World position
-    Texture2D openTexture;   // Texture for the open door
-    Texture2D closedTexture; // Texture for the closed door
+    Texture2D *openTexture;   // Texture for the open door (owned by the asset cache)
+    Texture2D *closedTexture; // Texture for the closed door (owned by the asset cache)
     bool isOpen;         // If the door is open or closed
     bool active;         // If the door is active
-    int spriteIndex;     // Index of the associated sprite
+    EntityHandle entity; // Entity of the door (position and sprite)
 } ExitDoor;
 
-// Add the declaration of the door as a global variable
-static ExitDoor exitDoor;
-
 // Game states
 typedef enum {
     GAME_TITLE,         // Title screen
@@ -71,10 +69,34 @@ typedef enum {
     GAME_OVER           // Player lost
 } GameState;
 
+// Input actions (bits of GameInput)
+typedef enum {
+    INPUT_FORWARD    = 1 << 0,  // Move forward
+    INPUT_BACKWARD   = 1 << 1,  // Move backward
+    INPUT_TURN_LEFT  = 1 << 2,  // Rotate left
+    INPUT_TURN_RIGHT = 1 << 3,  // Rotate right
+    INPUT_SHOOT      = 1 << 4,  // Attack
+    INPUT_PAUSE      = 1 << 5,  // Pause/resume
+    INPUT_START      = 1 << 6,  // Start the game from the title screen
+    INPUT_RESTART    = 1 << 7   // Restart after victory/defeat
+} InputAction;
+
+// Input sampled once per frame
+typedef struct {
+    unsigned int down;   // Actions held down (InputAction bits)
+    unsigned int pressed; // Actions pressed since the last frame (InputAction bits)
+    float deltaTime;     // Frame duration in seconds
+} GameInput;
+
+// Function providing the input of each frame (replaces the keyboard, see SetGameInputSource)
+typedef GameInput (*GameInputSource)(void);
+
 // Player structure
 typedef struct {
     Vector2 position;    // Position (x, y) on the map
+    Vector2 prevPosition; // Position at the previous simulation step (for interpolation)
     float angle;         // Direction angle in radians
+    float prevAngle;     // Angle at the previous simulation step (for interpolation)
     int health;          // Player health (0-100)
     int keys;            // Number of keys collected
     float shootCooldown; // Cooldown time between shots
@@ -90,45 +112,39 @@ typedef struct{
     float scale;         // Weapon scale
     int currentFrame;    // Current animation frame
     float frameTimer;    // Timer for frame change
-    Texture2D frames[5]; // Array to store animation frames
+    Texture2D *frames[5]; // Animation frames (owned by the asset cache)
 } WeaponAnimation;
 
-// Animation structure
-typedef struct {
-    int currentAnim;     // Current animation (0=idle, 1=walk, 2=attack, 3=pain, 4=death)
-    int currentFrame;    // Current animation frame
-    float frameTimer;    // Timer for frame change
-    bool isPlaying;      // If the animation is playing
-    bool loop;           // If the animation should loop
-} Animation;
-
+// Sprite as the renderer sees it (built from the transform and render components of an entity)
 typedef struct {
     Vector2 position;   // Position (x, y) on the map
-    Texture2D texture;  // Base sprite texture
-    bool active;        // If the sprite is active or not
+    Vector2 prevPosition; // Position at the previous simulation step (for interpolation)
+    Texture2D *texture; // Current texture, drawn whole (owned by the asset cache)
     CellType type;      // Cell type (key, enemy, etc.)
-    Animation anim;     // Sprite animation
-    Rectangle frame;    // Current animation frame (for cropping from texture)
 } Sprite;
 
-// Improved enemy structure
+// Immutable copy of everything the renderer needs, published by the simulation after its steps
+// (the renderer never reads the live game state, so both can run on different threads)
 typedef struct {
-    Vector2 position;    // Position (x, y) on the map
-    float angle;         // Direction angle
-    bool active;         // If the enemy is active or not
-    int health;          // Enemy health
-    float attackCooldown; // Cooldown time between attacks
-    float moveTimer;     // Timer for direction change
-    Vector2 direction;   // Current movement direction
-    Animation anim;      // Enemy animation
-    int spriteIndex;     // Index of the associated sprite
-    bool isDying;        // If the enemy is in death animation
-} Enemy;
+    GameState state;            // Screen to draw
+    Maze maze;                  // Walls of the current level
+    Vector2 playerPosition;     // Player pose at the last two simulation steps
+    Vector2 playerPrevPosition;
+    float playerAngle;
+    float playerPrevAngle;
+    float renderAlpha;          // Interpolation factor between the last two steps
+    int health;                 // HUD values
+    int keys;
+    bool showExitMessage;
+    int weaponFrame;            // Frame of the weapon animation
+    Sprite sprites[MAX_SPRITES]; // Keys, exit door and enemies
+    int spriteCount;
+} WorldSnapshot;
 
 // Handle game initialization
 void InitGame(void);
 
-// Update game logic
+// Update game logic (runs as many fixed simulation steps as the frame time requires)
 void UpdateGame(void);
 
 // Render the current frame
@@ -137,4 +153,37 @@ void RenderGame(void);
 // Free resources on close
 void CloseGame(void);
 
+// Read the keyboard into a GameInput (default input source)
+GameInput PollGameInput(void);
+
+// Read input from a custom source instead of the keyboard (NULL restores the keyboard)
+void SetGameInputSource(GameInputSource source);
+
+// Run without window, GPU or audio: no asset is loaded and RenderGame must not be called
+// (call before InitGame)
+void SetGameHeadless(bool headless);
+
+// Seed used for levels and enemy behaviour (0 = based on the current time, call before InitGame)
+void SetGameSeed(unsigned int seed);
+
+// Run the simulation on its own thread: UpdateGame only hands the frame input over and
+// RenderGame draws the latest world snapshot, so a frame costs the slower of both instead
+// of their sum (call before InitGame, ignored in headless mode)
+void SetGamePipelined(bool pipelined);
+
+// Current game state (owned by the simulation thread in pipelined mode)
+GameState GetGameState(void);
+
+// Number of simulation steps run since InitGame
+unsigned int GetGameTicks(void);
+
+#if defined(MAZERAY_BENCH)
+// Benchmark hooks, only built into the bench harness (tools/bench.c)
+void BenchStartLevel(unsigned int seed);        // Headless game on its first level, state saved
+void BenchRestoreLevel(void);                   // Back to the saved level state
+void BenchUpdateEnemies(float deltaTime);       // One step of the enemy update
+bool BenchCheckWallCollision(Vector2 position); // Player collision test
+const Maze *BenchGetMaze(void);                 // Maze of the current level
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "levelpool.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdio.h>
+
+// One slot per ready level plus the one being played
+#define LEVEL_SLOTS     (LEVEL_POOL_SIZE + 1)
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static Level levels[LEVEL_SLOTS];
+static int freeSlots[LEVEL_SLOTS];          // Stack of slots waiting to be generated
+static int freeCount = 0;
+static int readySlots[LEVEL_SLOTS];         // FIFO of generated slots (keeps the seed order)
+static int readyHead = 0;
+static int readyCount = 0;
+static unsigned int poolSeed = 0;
+static unsigned int nextSequence = 0;       // Index of the next level to generate
+
+static pthread_mutex_t poolMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t levelReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t slotFree = PTHREAD_COND_INITIALIZER;
+static pthread_t producerThread;
+static bool producerRunning = false;
+static bool stopRequested = false;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Generate a level and everything derived from it
+static void BuildLevel(Level *level, unsigned int seed) {
+    TraceBegin("Generate level");
+    
+    RandomState rng;
+    SeedRandomState(&rng, seed ^ 0x5bd1e995U);
+
+    ResetArena(&level->arena);
+    level->seed = seed;
+
+    GenerateMaze(&level->maze, seed);
+    level->startPosition = GridToWorld((int)level->maze.startPos.x, (int)level->maze.startPos.y);
+    level->exitPosition = GridToWorld((int)level->maze.exitPos.x, (int)level->maze.exitPos.y);
+
+    // Count the objects first so the arrays are allocated with their exact size
+    int keyCount = 0;
+    int enemyCount = 0;
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) {
+            CellType type = GetCellType(&level->maze, x, y);
+            if (type == CELL_KEY) keyCount++;
+            else if (type == CELL_ENEMY) enemyCount++;
+        }
+    }
+
+    level->keyPositions = ArenaAlloc(&level->arena, keyCount * sizeof(Vector2));
+    level->enemySpawns = ArenaAlloc(&level->arena, enemyCount * sizeof(EnemySpawn));
+    level->keyCount = 0;
+    level->enemyCount = 0;
+
+    // Same row-major order the game used to scan the grid in
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) {
+            CellType type = GetCellType(&level->maze, x, y);
+
+            if (type == CELL_KEY && level->keyPositions != NULL) {
+                level->keyPositions[level->keyCount++] = GridToWorld(x, y);
+            } else if (type == CELL_ENEMY && level->enemySpawns != NULL) {
+                EnemySpawn *spawn = &level->enemySpawns[level->enemyCount++];
+                spawn->position = GridToWorld(x, y);
+                spawn->angle = RandomFloat(&rng) * 2 * PI;
+                spawn->moveTimer = RandomFloat(&rng) * 2.0f;
+            }
+        }
+    }
+    
+    TraceEnd("Generate level");
+}
+
+// Seed of a level in the sequence (spread so consecutive levels differ)
+static unsigned int GetLevelSeed(unsigned int sequence) {
+    return poolSeed + sequence * 2654435761U;
+}
+
+// Producer thread: keep every free slot filled with a ready level
+static void *LevelPoolThread(void *arg) {
+    TraceSetThreadName("Level generator");
+    
+    pthread_mutex_lock(&poolMutex);
+
+    while (!stopRequested) {
+        if (freeCount == 0) {
+            pthread_cond_wait(&slotFree, &poolMutex);
+            continue;
+        }
+
+        int slot = freeSlots[--freeCount];
+        unsigned int sequence = nextSequence++;
+
+        // Generate without holding the lock
+        pthread_mutex_unlock(&poolMutex);
+        BuildLevel(&levels[slot], GetLevelSeed(sequence));
+        pthread_mutex_lock(&poolMutex);
+
+        readySlots[(readyHead + readyCount) % LEVEL_SLOTS] = slot;
+        readyCount++;
+        pthread_cond_signal(&levelReady);
+    }
+
+    pthread_mutex_unlock(&poolMutex);
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start the producer thread
+void StartLevelPool(unsigned int baseSeed) {
+    if (producerRunning) return;
+
+    poolSeed = baseSeed;
+    nextSequence = 0;
+    freeCount = 0;
+    readyHead = 0;
+    readyCount = 0;
+    stopRequested = false;
+
+    for (int i = LEVEL_SLOTS - 1; i >= 0; i--) {
+        if (levels[i].arena.base == NULL) InitArena(&levels[i].arena, LEVEL_ARENA_SIZE);
+        freeSlots[freeCount++] = i;
+    }
+
+    if (pthread_create(&producerThread, NULL, LevelPoolThread, NULL) == 0) {
+        producerRunning = true;
+    } else {
+        printf("Error starting level pool thread, levels will be generated on demand\n");
+    }
+}
+
+// Take the next ready level
+Level *AcquireLevel(void) {
+    pthread_mutex_lock(&poolMutex);
+
+    // Without a producer thread the level is generated right here
+    if (!producerRunning && readyCount == 0 && freeCount > 0) {
+        int slot = freeSlots[--freeCount];
+        BuildLevel(&levels[slot], GetLevelSeed(nextSequence++));
+        readySlots[(readyHead + readyCount) % LEVEL_SLOTS] = slot;
+        readyCount++;
+    }
+
+    // A wait here means the producer fell behind (visible as a stutter on restart)
+    bool waited = (readyCount == 0);
+    if (waited) TraceBegin("Wait for level");
+    while (readyCount == 0) {
+        pthread_cond_wait(&levelReady, &poolMutex);
+    }
+    if (waited) TraceEnd("Wait for level");
+
+    int slot = readySlots[readyHead];
+    readyHead = (readyHead + 1) % LEVEL_SLOTS;
+    readyCount--;
+
+    pthread_mutex_unlock(&poolMutex);
+
+    return &levels[slot];
+}
+
+// Give a level back to the pool
+void ReleaseLevel(Level *level) {
+    if (level == NULL) return;
+
+    // Every allocation of the level goes away at once
+    ResetArena(&level->arena);
+    level->keyPositions = NULL;
+    level->enemySpawns = NULL;
+
+    pthread_mutex_lock(&poolMutex);
+    freeSlots[freeCount++] = (int)(level - levels);
+    pthread_cond_signal(&slotFree);
+    pthread_mutex_unlock(&poolMutex);
+}
+
+// Stop the producer thread and free every level
+void StopLevelPool(void) {
+    if (producerRunning) {
+        pthread_mutex_lock(&poolMutex);
+        stopRequested = true;
+        pthread_cond_signal(&slotFree);
+        pthread_mutex_unlock(&poolMutex);
+
+        pthread_join(producerThread, NULL);
+        producerRunning = false;
+    }
+
+    // Budget report: the level that needed the most memory, failures of every slot
+    Arena summary = levels[0].arena;
+    for (int i = 1; i < LEVEL_SLOTS; i++) {
+        if (levels[i].arena.peak > summary.peak) summary.peak = levels[i].arena.peak;
+        summary.failures += levels[i].arena.failures;
+    }
+    ReportArena(&summary, "Level");
+
+    for (int i = 0; i < LEVEL_SLOTS; i++) {
+        FreeArena(&levels[i].arena);
+    }
+
+    freeCount = 0;
+    readyCount = 0;
+}
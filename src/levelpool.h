@@ -0,0 +1,44 @@
+#ifndef LEVELPOOL_H
+#define LEVELPOOL_H
+
+#include "raylib.h"
+#include "maze.h"
+#include "utils.h"
+
+// Level pool configuration
+#define LEVEL_POOL_SIZE     3        // Levels kept ready by the producer thread
+#define LEVEL_ARENA_SIZE    (MAZE_WIDTH * MAZE_HEIGHT * (sizeof(EnemySpawn) + sizeof(Vector2)) + 256)
+
+// Initial state of an enemy
+typedef struct {
+    Vector2 position;       // World position
+    float angle;            // Initial direction angle
+    float moveTimer;        // Time until the first direction change
+} EnemySpawn;
+
+// Ready-to-play level: maze plus everything derived from it
+typedef struct {
+    unsigned int seed;      // Seed the level was generated from
+    Maze maze;              // Generated maze
+    Vector2 startPosition;  // Player start (world coordinates)
+    Vector2 exitPosition;   // Exit door (world coordinates)
+    Vector2 *keyPositions;  // Key sprites (world coordinates, allocated from the arena)
+    int keyCount;
+    EnemySpawn *enemySpawns; // Enemies (allocated from the arena)
+    int enemyCount;
+    Arena arena;            // Every per-level allocation, released in one step
+} Level;
+
+// Start the producer thread, levels are generated from baseSeed in a fixed sequence
+void StartLevelPool(unsigned int baseSeed);
+
+// Take the next ready level (O(1), only waits if the producer fell behind)
+Level *AcquireLevel(void);
+
+// Give a level back to the pool once the game doesn't use it anymore
+void ReleaseLevel(Level *level);
+
+// Stop the producer thread and free every level
+void StopLevelPool(void);
+
+#endif // LEVELPOOL_H
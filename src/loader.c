@@ -0,0 +1,288 @@
+#include "loader.h"
+#include "pack.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// Types of assets the loader handles
+typedef enum {
+    LOAD_TEXTURE,
+    LOAD_SOUND
+} LoadType;
+
+// Queued asset, decoded by the worker and uploaded by the main thread
+typedef struct {
+    LoadType type;
+    char fileName[64];
+    char fallbackFileName[64];
+    TextureAsset *texture;   // Destination for LOAD_TEXTURE
+    Sound *sound;            // Destination for LOAD_SOUND
+    Image image;             // Decoded pixels
+    Wave wave;               // Decoded samples
+    bool ownsData;           // False when the data points into the mapped asset pack
+} LoadRequest;
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static LoadRequest requests[MAX_LOAD_REQUESTS];
+static int requestCount = 0;
+static int uploadedCount = 0;                 // Requests uploaded by the main thread
+static atomic_int decodedCount;               // Requests decoded by the worker (always a prefix)
+static atomic_bool stopRequested;
+static pthread_t workerThread;
+static bool workerRunning = false;
+static bool loaderStarted = false;            // No more requests can be queued once started
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Fault in the pages of a mapped pack entry so the upload doesn't block on disk I/O
+static void PrefetchPackData(const PackEntry *entry) {
+    const volatile unsigned char *data = GetPackEntryData(entry);
+    unsigned char sink = 0;
+
+    for (unsigned int offset = 0; offset < entry->size; offset += 4096) {
+        sink ^= data[offset];
+    }
+    (void)sink;
+}
+
+// Read and decode the data of one request
+static void ReadRequestData(LoadRequest *request) {
+    const PackEntry *entry = FindPackEntry(request->fileName);
+
+    if (request->type == LOAD_TEXTURE) {
+        if (entry != NULL && entry->type == PACK_ENTRY_IMAGE) {
+            PrefetchPackData(entry);
+            request->image = (Image){ (void *)GetPackEntryData(entry), entry->width, entry->height, 1, entry->format };
+            request->ownsData = false;
+            return;
+        }
+
+        request->image = LoadImage(request->fileName);
+        if (request->image.data == NULL && request->fallbackFileName[0] != '\0') {
+            request->image = LoadImage(request->fallbackFileName);
+        }
+        if (request->image.data != NULL) {
+            ImageFormat(&request->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        }
+        request->ownsData = true;
+    } else {
+        if (entry != NULL && entry->type == PACK_ENTRY_WAVE) {
+            PrefetchPackData(entry);
+            request->wave = (Wave){ entry->width, entry->height, entry->format, entry->channels, (void *)GetPackEntryData(entry) };
+            request->ownsData = false;
+            return;
+        }
+
+        request->wave = LoadWave(request->fileName);
+        request->ownsData = true;
+    }
+}
+
+// Read and decode one request (worker thread), traced under the asset name
+static void DecodeRequest(LoadRequest *request) {
+    char eventName[TRACE_NAME_SIZE] = "Decode";
+    if (IsTraceEnabled()) snprintf(eventName, sizeof(eventName), "Decode %s", GetFileName(request->fileName));
+    
+    TRACE_SCOPE(eventName) ReadRequestData(request);
+}
+
+// Upload one decoded request (main thread), texture pixels are handed over to the
+// destination and sound samples are released
+static void UploadRequest(LoadRequest *request) {
+    char eventName[TRACE_NAME_SIZE] = "Upload";
+    if (IsTraceEnabled()) snprintf(eventName, sizeof(eventName), "Upload %s", GetFileName(request->fileName));
+    TraceBegin(eventName);
+    
+    if (request->type == LOAD_TEXTURE) {
+        if (request->image.data != NULL) {
+            request->texture->texture = LoadTextureFromImage(request->image);
+            request->texture->image = request->image;
+            request->texture->ownsImage = request->ownsData;
+        } else {
+            printf("Error loading texture: %s\n", request->fileName);
+        }
+    } else {
+        if (request->wave.data != NULL) {
+            *request->sound = LoadSoundFromWave(request->wave);
+            if (request->ownsData) UnloadWave(request->wave);
+        } else {
+            printf("Error loading sound: %s\n", request->fileName);
+        }
+    }
+
+    request->image.data = NULL;
+    request->wave.data = NULL;
+    
+    TraceEnd(eventName);
+}
+
+// Free the CPU data of a decoded request that will never be uploaded
+static void DiscardRequest(LoadRequest *request) {
+    if (request->ownsData) {
+        if (request->image.data != NULL) UnloadImage(request->image);
+        if (request->wave.data != NULL) UnloadWave(request->wave);
+    }
+
+    request->image.data = NULL;
+    request->wave.data = NULL;
+}
+
+// Worker thread: decode every request in queue order
+static void *LoaderThread(void *arg) {
+    TraceSetThreadName("Asset loader");
+    
+    for (int i = 0; i < requestCount; i++) {
+        if (atomic_load(&stopRequested)) break;
+
+        DecodeRequest(&requests[i]);
+        atomic_store_explicit(&decodedCount, i + 1, memory_order_release);
+    }
+
+    return NULL;
+}
+
+// Add a request to the queue (must be called before StartAssetLoader)
+static LoadRequest *AddRequest(LoadType type, const char *fileName) {
+    if (loaderStarted) return NULL;
+
+    if (requestCount >= MAX_LOAD_REQUESTS) {
+        printf("Error queuing asset: %s\n", fileName);
+        return NULL;
+    }
+
+    LoadRequest *request = &requests[requestCount++];
+    memset(request, 0, sizeof(LoadRequest));
+    request->type = type;
+    snprintf(request->fileName, sizeof(request->fileName), "%s", fileName);
+
+    return request;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Queue a texture
+bool QueueTextureLoad(const char *fileName, const char *fallbackFileName, TextureAsset *target) {
+    LoadRequest *request = AddRequest(LOAD_TEXTURE, fileName);
+    if (request == NULL) return false;
+
+    if (fallbackFileName != NULL) {
+        snprintf(request->fallbackFileName, sizeof(request->fallbackFileName), "%s", fallbackFileName);
+    }
+    request->texture = target;
+    return true;
+}
+
+// Queue a sound
+bool QueueSoundLoad(const char *fileName, Sound *target) {
+    LoadRequest *request = AddRequest(LOAD_SOUND, fileName);
+    if (request == NULL) return false;
+
+    request->sound = target;
+    return true;
+}
+
+// Load a texture right away
+TextureAsset LoadTextureAsset(const char *fileName, const char *fallbackFileName) {
+    TextureAsset texture = { 0 };
+    LoadRequest request = { 0 };
+    request.type = LOAD_TEXTURE;
+    request.texture = &texture;
+    snprintf(request.fileName, sizeof(request.fileName), "%s", fileName);
+    if (fallbackFileName != NULL) {
+        snprintf(request.fallbackFileName, sizeof(request.fallbackFileName), "%s", fallbackFileName);
+    }
+
+    DecodeRequest(&request);
+    UploadRequest(&request);
+
+    return texture;
+}
+
+// Load a sound right away
+Sound LoadSoundAsset(const char *fileName) {
+    Sound sound = { 0 };
+    LoadRequest request = { 0 };
+    request.type = LOAD_SOUND;
+    request.sound = &sound;
+    snprintf(request.fileName, sizeof(request.fileName), "%s", fileName);
+
+    DecodeRequest(&request);
+    UploadRequest(&request);
+
+    return sound;
+}
+
+// Start the worker thread
+void StartAssetLoader(void) {
+    if (loaderStarted) return;
+
+    loaderStarted = true;
+    uploadedCount = 0;
+    atomic_store(&decodedCount, 0);
+    atomic_store(&stopRequested, false);
+
+    if (pthread_create(&workerThread, NULL, LoaderThread, NULL) == 0) {
+        workerRunning = true;
+    } else {
+        // No thread available: decode everything right here
+        LoaderThread(NULL);
+    }
+}
+
+// Upload decoded assets within a time budget
+void UpdateAssetLoader(double budget) {
+    double startTime = GetTime();
+    int decoded = atomic_load_explicit(&decodedCount, memory_order_acquire);
+
+    // Always upload at least one asset per call so loading can't stall
+    while (uploadedCount < decoded) {
+        UploadRequest(&requests[uploadedCount]);
+        uploadedCount++;
+
+        if (GetTime() - startTime >= budget) break;
+    }
+
+    if (workerRunning && uploadedCount == requestCount) {
+        pthread_join(workerThread, NULL);
+        workerRunning = false;
+    }
+}
+
+// Fraction of the queued assets already uploaded
+float GetAssetLoadProgress(void) {
+    if (requestCount == 0) return 1.0f;
+
+    return (float)uploadedCount / (float)requestCount;
+}
+
+// Check if every queued asset has been uploaded
+bool IsAssetLoadComplete(void) {
+    return uploadedCount == requestCount;
+}
+
+// Wait for the worker thread and drop pending assets
+void StopAssetLoader(void) {
+    if (workerRunning) {
+        atomic_store(&stopRequested, true);
+        pthread_join(workerThread, NULL);
+        workerRunning = false;
+    }
+
+    int decoded = atomic_load(&decodedCount);
+    for (int i = uploadedCount; i < decoded; i++) {
+        DiscardRequest(&requests[i]);
+    }
+
+    requestCount = 0;
+    uploadedCount = 0;
+    atomic_store(&decodedCount, 0);
+    loaderStarted = false;
+}
@@ -0,0 +1,45 @@
+#ifndef LOADER_H
+#define LOADER_H
+
+#include "raylib.h"
+
+// Asset loader configuration
+#define MAX_LOAD_REQUESTS       96       // Maximum number of queued assets
+#define ASSET_UPLOAD_BUDGET     0.004    // Seconds per frame spent uploading finished assets
+
+// Loaded texture: GPU copy plus the RGBA8 pixels kept on the CPU for pixel queries
+typedef struct {
+    Texture2D texture;
+    Image image;             // CPU pixels (PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+    bool ownsImage;          // False when the pixels point into the mapped asset pack
+} TextureAsset;
+
+// Queue a texture, fallbackFileName (may be NULL) is tried if the first file fails
+// Returns false if the loader was already started or the queue is full
+bool QueueTextureLoad(const char *fileName, const char *fallbackFileName, TextureAsset *target);
+
+// Queue a sound, returns false if the loader was already started or the queue is full
+bool QueueSoundLoad(const char *fileName, Sound *target);
+
+// Load a texture right away on the calling thread (main thread only)
+TextureAsset LoadTextureAsset(const char *fileName, const char *fallbackFileName);
+
+// Load a sound right away on the calling thread (main thread only)
+Sound LoadSoundAsset(const char *fileName);
+
+// Start the worker thread that reads and decodes the queued assets
+void StartAssetLoader(void);
+
+// Upload decoded assets to the GPU/audio device (main thread only) within a time budget
+void UpdateAssetLoader(double budget);
+
+// Fraction of the queued assets already uploaded (0.0 to 1.0)
+float GetAssetLoadProgress(void);
+
+// Check if every queued asset has been uploaded
+bool IsAssetLoadComplete(void);
+
+// Wait for the worker thread and drop any asset not uploaded yet
+void StopAssetLoader(void);
+
+#endif // LOADER_H
@@ -10,6 +10,12 @@
 #include "game.h"
 #include "maze.h"
 #include "utils.h"
+#include "replay.h"
+#include "profiler.h"
+#include "trace.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
 
 #define WINDOW_TITLE     "MazeRay v1.0"
 
@@ -17,29 +23,104 @@
 #define SCREEN_WIDTH     1280
 #define SCREEN_HEIGHT    720
 #define FULLSCREEN       1
+#define PROFILER_KEY     KEY_F3  // Shows/hides the frame profiler overlay
+#define TARGET_FPS       60      // Render rate (0 = uncapped), the simulation always runs at SIM_TICK_RATE
 
-int main(void) {
+static double replayStartTime = 0.0;   // Time the first replay frame was played
+
+// Keyboard input, also stored in the replay being recorded
+static GameInput RecordInput(void) {
+    GameInput input = PollGameInput();
+    RecordReplayFrame(input);
+    return input;
+}
+
+// Input read back from the open replay
+static GameInput ReplayInput(void) {
+    GameInput input;
+    if (replayStartTime == 0.0) replayStartTime = GetTime();
+    ReadReplayFrame(&input);
+    return input;
+}
+
+int main(int argc, char *argv[]) {
+    // Command line: --record <file> saves the input of the session, --replay <file> plays it again
+    // --profile <file.csv> writes the frame profile of every frame and --trace <file.json> saves
+    // a timeline of the session (Chrome trace-event format), --pipelined runs the simulation on
+    // its own thread, in parallel with the rendering
+    const char *recordFile = NULL;
+    const char *replayFile = NULL;
+    const char *profileFile = NULL;
+    const char *traceFile = NULL;
+    bool pipelined = false;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordFile = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayFile = argv[++i];
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) profileFile = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) traceFile = argv[++i];
+        else if (strcmp(argv[i], "--pipelined") == 0) pipelined = true;
+    }
+    
+    SetGamePipelined(pipelined);
+    
+    if (replayFile != NULL) {
+        if (!OpenReplay(replayFile)) return 1;
+        SetGameSeed(GetReplaySeed());
+        SetGameInputSource(ReplayInput);
+    } else if (recordFile != NULL) {
+        unsigned int seed = (unsigned int)time(NULL);
+        if (seed == 0) seed = 1;
+        if (StartReplayRecording(recordFile, seed)) {
+            SetGameSeed(seed);
+            SetGameInputSource(RecordInput);
+        }
+    }
+    
     // Init window and audio device
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, WINDOW_TITLE);
     InitAudioDevice();
     
-    SetTargetFPS(60);
+    // Replays are fixed workloads: render uncapped so frame times can be compared
+    SetTargetFPS((replayFile != NULL) ? 0 : TARGET_FPS);
     
     #if FULLSCREEN
     ToggleFullscreen();
     #endif
     
+    // Start tracing before InitGame so asset loading and level generation are recorded
+    if (traceFile != NULL) StartTrace(traceFile);
+    
     // Initialize game variables
-    InitGame();
+    TRACE_SCOPE("InitGame") InitGame();
+    
+    if (profileFile != NULL) StartProfileCsv(profileFile);
     
     // Main game loop
     while (!WindowShouldClose()) {  
-        UpdateGame();               
-        RenderGame();                
+        // Debug keys stay out of the game input (and out of replays)
+        if (IsKeyPressed(PROFILER_KEY)) ToggleProfilerOverlay();
+        
+        TRACE_SCOPE("UpdateGame") UpdateGame();
+        TRACE_SCOPE("RenderGame") RenderGame();
+        ProfileEndFrame();
+        
+        if (replayFile != NULL && IsReplayFinished()) break;
+    }
+    
+    // Replay workload time (asset loading isn't included, the first frame is read once it's done)
+    if (replayFile != NULL && IsReplayFinished() && GetReplayFrameCount() > 0) {
+        double elapsed = GetTime() - replayStartTime;
+        printf("Replay finished: %d frames in %.3f s (%.3f ms/frame)\n", GetReplayFrameCount(), elapsed,
+               1000.0 * elapsed / GetReplayFrameCount());
     }
     
     // Free resources
+    StopProfileCsv();
+    StopReplayRecording();
+    CloseReplay();
     CloseGame();
+    StopTrace();    // After CloseGame: the loader and level generator threads have finished
     CloseWindow();
     
     return 0;
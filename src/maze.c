@@ -1,4 +1,5 @@
 #include "maze.h"
+#include "utils.h"
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
@@ -6,6 +7,16 @@
 // Constants for maze generation
 #define GRID_SCALE 1.0f   // Scale to convert grid coordinates to world coordinates
 
+// Grid being generated (row-major cells, any size)
+typedef struct {
+    unsigned char *cells;
+    int width;
+    int height;
+} MazeGrid;
+
+// Cell of a grid being generated
+#define GRID_CELL(g, x, y) ((g)->cells[(y) * (g)->width + (x)])
+
 // Possible directions for the generation algorithm
 typedef enum {
     DIR_NORTH = 0,
@@ -23,14 +34,14 @@ const int DIRS[4][2] = {
 };
 
 // Helper function to randomly shuffle a list of directions
-static void ShuffleDirections(int dirs[4]) {
+static void ShuffleDirections(int dirs[4], RandomState* rng) {
     for (int i = 0; i < 4; i++) {
         dirs[i] = i;
     }
     
     // Fisher-Yates algorithm for shuffling
     for (int i = 3; i > 0; i--) {
-        int j = rand() % (i + 1);
+        int j = RandomNext(rng) % (i + 1);
         // Swap
         int temp = dirs[i];
         dirs[i] = dirs[j];
@@ -39,31 +50,31 @@ static void ShuffleDirections(int dirs[4]) {
 }
 
 // Recursive function to generate the maze using DFS
-static void CarveMaze(Maze* maze, int x, int y) {
+static void CarveMaze(MazeGrid* maze, int x, int y, RandomState* rng) {
     int dirs[4];
-    ShuffleDirections(dirs);
+    ShuffleDirections(dirs, rng);
     
     for (int i = 0; i < 4; i++) {
         int nextX = x + DIRS[dirs[i]][0] * 2;
         int nextY = y + DIRS[dirs[i]][1] * 2;
         
         // Check if it's within bounds
-        if (nextX > 0 && nextX < MAZE_WIDTH - 1 && nextY > 0 && nextY < MAZE_HEIGHT - 1) {
+        if (nextX > 0 && nextX < maze->width - 1 && nextY > 0 && nextY < maze->height - 1) {
             // If the cell hasn't been visited (still a wall)
-            if (maze->grid[nextY][nextX] == CELL_WALL) {
+            if (GRID_CELL(maze, nextX, nextY) == CELL_WALL) {
                 // Open path
-                maze->grid[y + DIRS[dirs[i]][1]][x + DIRS[dirs[i]][0]] = CELL_EMPTY;
-                maze->grid[nextY][nextX] = CELL_EMPTY;
+                GRID_CELL(maze, x + DIRS[dirs[i]][0], y + DIRS[dirs[i]][1]) = CELL_EMPTY;
+                GRID_CELL(maze, nextX, nextY) = CELL_EMPTY;
                 
                 // Continue carving from the new position
-                CarveMaze(maze, nextX, nextY);
+                CarveMaze(maze, nextX, nextY, rng);
             }
         }
     }
 }
 
 // Place objects in the maze (keys, exit)
-static void PlaceObjects(Maze* maze) {
+static void PlaceObjects(MazeGrid* maze, Vector2 startPos, Vector2* exitPos, RandomState* rng) {
     int keys = 0;
     int enemies = 0;
     int maxKeys = 3; // We could parameterize this in a more advanced version
@@ -73,12 +84,12 @@ static void PlaceObjects(Maze* maze) {
     int exitX, exitY;
     float maxDist = 0;
     
-    for (int y = 1; y < MAZE_HEIGHT - 1; y++) {
-        for (int x = 1; x < MAZE_WIDTH - 1; x++) {
-            if (maze->grid[y][x] == CELL_EMPTY) {
+    for (int y = 1; y < maze->height - 1; y++) {
+        for (int x = 1; x < maze->width - 1; x++) {
+            if (GRID_CELL(maze, x, y) == CELL_EMPTY) {
                 // Calculate distance to start
-                float dx = x - maze->startPos.x;
-                float dy = y - maze->startPos.y;
+                float dx = x - startPos.x;
+                float dy = y - startPos.y;
                 float dist = dx*dx + dy*dy;
                 
                 if (dist > maxDist) {
@@ -91,18 +102,18 @@ static void PlaceObjects(Maze* maze) {
     }
     
     // Place exit
-    maze->grid[exitY][exitX] = CELL_EXIT;
-    maze->exitPos = (Vector2){ (float)exitX, (float)exitY };
+    GRID_CELL(maze, exitX, exitY) = CELL_EXIT;
+    *exitPos = (Vector2){ (float)exitX, (float)exitY };
     
     // Place keys randomly
     while (keys < maxKeys) {
-        int x = rand() % (MAZE_WIDTH - 2) + 1;
-        int y = rand() % (MAZE_HEIGHT - 2) + 1;
+        int x = RandomNext(rng) % (maze->width - 2) + 1;
+        int y = RandomNext(rng) % (maze->height - 2) + 1;
         
-        if (maze->grid[y][x] == CELL_EMPTY) {
+        if (GRID_CELL(maze, x, y) == CELL_EMPTY) {
             // Make sure the key is not too close to the start or exit
-            float dx1 = x - maze->startPos.x;
-            float dy1 = y - maze->startPos.y;
+            float dx1 = x - startPos.x;
+            float dy1 = y - startPos.y;
             float dx2 = x - exitX;
             float dy2 = y - exitY;
             
@@ -112,7 +123,7 @@ static void PlaceObjects(Maze* maze) {
             
             // Keys must be at a certain minimum distance
             if (distToStart > 5 && distToExit > 5) {
-                maze->grid[y][x] = CELL_KEY;
+                GRID_CELL(maze, x, y) = CELL_KEY;
                 keys++;
             }
         }
@@ -120,17 +131,17 @@ static void PlaceObjects(Maze* maze) {
     
     // Place enemies
     while (enemies < maxEnemies) {
-        int x = rand() % (MAZE_WIDTH - 2) + 1;
-        int y = rand() % (MAZE_HEIGHT - 2) + 1;
+        int x = RandomNext(rng) % (maze->width - 2) + 1;
+        int y = RandomNext(rng) % (maze->height - 2) + 1;
         
-        if (maze->grid[y][x] == CELL_EMPTY) {
+        if (GRID_CELL(maze, x, y) == CELL_EMPTY) {
             // Don't place enemies too close to the start
-            float dx = x - maze->startPos.x;
-            float dy = y - maze->startPos.y;
+            float dx = x - startPos.x;
+            float dy = y - startPos.y;
             float distToStart = dx*dx + dy*dy;
             
             if (distToStart > 9) { // Minimum distance
-                maze->grid[y][x] = CELL_ENEMY;
+                GRID_CELL(maze, x, y) = CELL_ENEMY;
                 enemies++;
             }
         }
@@ -138,23 +149,87 @@ static void PlaceObjects(Maze* maze) {
 }
 
 // Generate a new random maze
-void GenerateMaze(Maze* maze) {
+void GenerateMaze(Maze* maze, unsigned int seed) {
+    GenerateMazeGrid(&maze->grid[0][0], MAZE_WIDTH, MAZE_HEIGHT, seed, &maze->startPos, &maze->exitPos);
+    BakeMazeLight(maze);
+}
+
+// Bake the light levels of a maze
+void BakeMazeLight(Maze* maze) {
+    // Light sources
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) {
+            switch (maze->grid[y][x]) {
+                case CELL_EXIT: maze->light[y][x] = LIGHT_LEVELS - 1; break;
+                case CELL_KEY:  maze->light[y][x] = LIGHT_LEVELS - 3; break;
+                default:        maze->light[y][x] = LIGHT_AMBIENT; break;
+            }
+        }
+    }
+
+    // The start stays an empty cell in the grid, its light comes from startPos
+    maze->light[(int)maze->startPos.y][(int)maze->startPos.x] = LIGHT_LEVELS - 1;
+
+    // Spread from the brightest level down, one level per cell (a breadth-first flood of every
+    // source at once, the grid is small enough to sweep it once per level)
+    for (int level = LIGHT_LEVELS - 1; level > LIGHT_AMBIENT + 1; level--) {
+        for (int y = 0; y < MAZE_HEIGHT; y++) {
+            for (int x = 0; x < MAZE_WIDTH; x++) {
+                if (maze->light[y][x] != level || maze->grid[y][x] == CELL_WALL) continue;
+
+                for (int d = 0; d < 4; d++) {
+                    int nx = x + DIRS[d][0];
+                    int ny = y + DIRS[d][1];
+
+                    if (IsCellWalkable(maze, nx, ny) && maze->light[ny][nx] < level - 1) {
+                        maze->light[ny][nx] = (unsigned char)(level - 1);
+                    }
+                }
+            }
+        }
+    }
+
+    // Walls show the light of the corridor in front of them
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) {
+            if (maze->grid[y][x] != CELL_WALL) continue;
+
+            for (int d = 0; d < 4; d++) {
+                int nx = x + DIRS[d][0];
+                int ny = y + DIRS[d][1];
+
+                if (IsCellWalkable(maze, nx, ny) && maze->light[ny][nx] > maze->light[y][x]) {
+                    maze->light[y][x] = maze->light[ny][nx];
+                }
+            }
+        }
+    }
+}
+
+// Generate a maze of any size
+void GenerateMazeGrid(unsigned char* cells, int width, int height, unsigned int seed, Vector2* startPos, Vector2* exitPos) {
+    MazeGrid grid = { cells, width, height };
+    
+    // Each maze has its own generator so levels can be built on any thread
+    RandomState rng;
+    SeedRandomState(&rng, seed);
+    
     // Initialize everything as walls
-    memset(maze->grid, CELL_WALL, sizeof(maze->grid));
+    memset(cells, CELL_WALL, (size_t)width * height);
     
     // Choose random starting point (must be odd)
     int startX = 1;
     int startY = 1;
     
     // Mark start as empty space
-    maze->grid[startY][startX] = CELL_EMPTY;
-    maze->startPos = (Vector2){ (float)startX, (float)startY };
+    GRID_CELL(&grid, startX, startY) = CELL_EMPTY;
+    *startPos = (Vector2){ (float)startX, (float)startY };
     
     // Start recursive generation
-    CarveMaze(maze, startX, startY);
+    CarveMaze(&grid, startX, startY, &rng);
     
     // Place objects
-    PlaceObjects(maze);
+    PlaceObjects(&grid, *startPos, exitPos, &rng);
 }
 
 // Get cell type at a specific position
@@ -7,6 +7,10 @@
 #define MAZE_WIDTH      15
 #define MAZE_HEIGHT     15
 
+// Baked lighting
+#define LIGHT_LEVELS    16      // Light levels of a cell (0 = dark, LIGHT_LEVELS-1 = fully lit)
+#define LIGHT_AMBIENT   5       // Light of the cells no light source reaches
+
 // Cell types
 typedef enum {
     CELL_EMPTY = 0,     // Empty space
@@ -22,10 +26,20 @@ typedef struct {
     unsigned char grid[MAZE_HEIGHT][MAZE_WIDTH];  // Maze grid (0=empty, 1=wall)
     Vector2 startPos;                           // Initial position
     Vector2 exitPos;                            // Final position
+    unsigned char light[MAZE_HEIGHT][MAZE_WIDTH]; // Baked light level of each cell (walls included)
 } Maze;
 
-// Generate a new maze 
-void GenerateMaze(Maze* maze);
+// Generate a new maze (the same seed always gives the same maze, safe to call from any thread)
+void GenerateMaze(Maze* maze, unsigned int seed);
+
+// Bake the light levels of a maze: the start (startPos), the exit and the keys are light
+// sources that fade one level per cell walked away from them, down to LIGHT_AMBIENT. Walls
+// take the light of their brightest walkable neighbour, which is the side the player sees
+void BakeMazeLight(Maze* maze);
+
+// Generate a maze of any size into a row-major grid of width * height cells (odd sizes,
+// GenerateMaze uses MAZE_WIDTH x MAZE_HEIGHT)
+void GenerateMazeGrid(unsigned char* cells, int width, int height, unsigned int seed, Vector2* startPos, Vector2* exitPos);
 
 // Obtain the type of cell at a given position
 CellType GetCellType(Maze* maze, int x, int y);
@@ -0,0 +1,186 @@
+#include "pack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static const unsigned char *packData = NULL;    // Mapped archive
+static size_t packSize = 0;                     // Mapped size
+static const PackEntry *packEntries = NULL;     // Table of contents (inside the mapping)
+static uint32_t packEntryCount = 0;
+
+#if defined(_WIN32)
+static HANDLE packFile = INVALID_HANDLE_VALUE;
+static HANDLE packMapping = NULL;
+#endif
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Map a whole file in read-only mode
+static bool MapFile(const char *fileName) {
+#if defined(_WIN32)
+    packFile = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (packFile == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(packFile, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(packFile);
+        packFile = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    packMapping = CreateFileMappingA(packFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (packMapping != NULL) packData = MapViewOfFile(packMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (packData == NULL) {
+        if (packMapping != NULL) CloseHandle(packMapping);
+        CloseHandle(packFile);
+        packMapping = NULL;
+        packFile = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    packSize = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+
+    if (data == MAP_FAILED) return false;
+
+    // The whole archive is needed during startup: ask for a single sequential read-ahead
+    // instead of faulting pages in one by one
+    madvise(data, (size_t)st.st_size, MADV_WILLNEED);
+
+    packData = data;
+    packSize = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+// Release the current mapping
+static void UnmapFile(void) {
+#if defined(_WIN32)
+    if (packData != NULL) UnmapViewOfFile(packData);
+    if (packMapping != NULL) CloseHandle(packMapping);
+    if (packFile != INVALID_HANDLE_VALUE) CloseHandle(packFile);
+    packMapping = NULL;
+    packFile = INVALID_HANDLE_VALUE;
+#else
+    if (packData != NULL) munmap((void *)packData, packSize);
+#endif
+    packData = NULL;
+    packSize = 0;
+}
+
+// Verify the header and the table of contents of the mapped archive
+static bool ValidatePack(void) {
+    if (packSize < sizeof(PackHeader)) return false;
+
+    const PackHeader *header = (const PackHeader *)packData;
+    if (memcmp(header->magic, PACK_MAGIC, 4) != 0) return false;
+    if (header->version != PACK_VERSION) return false;
+    if (header->fileSize != packSize) return false;
+
+    uint64_t tocEnd = (uint64_t)header->tocOffset + (uint64_t)header->entryCount * sizeof(PackEntry);
+    if (header->tocOffset % sizeof(uint32_t) != 0 || tocEnd > packSize) return false;
+
+    const PackEntry *entries = (const PackEntry *)(packData + header->tocOffset);
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        if (entries[i].name[PACK_NAME_SIZE - 1] != '\0') return false;
+        if (entries[i].offset % PACK_ALIGNMENT != 0) return false;
+        if ((uint64_t)entries[i].offset + entries[i].size > packSize) return false;
+
+        // Lookups are a binary search: names strictly increasing
+        if (i > 0 && strncmp(entries[i - 1].name, entries[i].name, PACK_NAME_SIZE) >= 0) return false;
+
+        // Images and waves are used in place by the uploads, their size must match what they describe
+        if (entries[i].type == PACK_ENTRY_IMAGE &&
+            (entries[i].format != PACK_IMAGE_FORMAT || (uint64_t)entries[i].width * entries[i].height * 4 != entries[i].size)) return false;
+        if (entries[i].type == PACK_ENTRY_WAVE &&
+            (uint64_t)entries[i].width * entries[i].channels * (entries[i].format / 8) != entries[i].size) return false;
+
+        // Palettes and indices are used in place, their size must match what they describe
+        if (entries[i].type == PACK_ENTRY_PALETTE &&
+            (entries[i].size != PACK_PALETTE_COLORS * 4 || entries[i].width > PACK_PALETTE_COLORS)) return false;
+        if (entries[i].type == PACK_ENTRY_INDEXED &&
+            (uint64_t)entries[i].width * entries[i].height != entries[i].size) return false;
+    }
+
+    packEntries = entries;
+    packEntryCount = header->entryCount;
+    return true;
+}
+
+// Compare function for the table of contents binary search
+static int CompareEntryName(const void *key, const void *entry) {
+    return strncmp((const char *)key, ((const PackEntry *)entry)->name, PACK_NAME_SIZE);
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Memory-map an asset archive
+bool OpenAssetPack(const char *fileName) {
+    CloseAssetPack();
+
+    if (!MapFile(fileName)) return false;
+
+    if (!ValidatePack()) {
+        printf("Invalid asset pack: %s\n", fileName);
+        UnmapFile();
+        return false;
+    }
+
+    return true;
+}
+
+// Unmap the open archive
+void CloseAssetPack(void) {
+    UnmapFile();
+    packEntries = NULL;
+    packEntryCount = 0;
+}
+
+// Check if an archive is currently open
+bool IsAssetPackOpen(void) {
+    return packData != NULL;
+}
+
+// Find an entry by asset path
+const PackEntry *FindPackEntry(const char *name) {
+    if (packEntries == NULL || name == NULL) return NULL;
+
+    return (const PackEntry *)bsearch(name, packEntries, packEntryCount, sizeof(PackEntry), CompareEntryName);
+}
+
+// Get a pointer to the data of an entry
+const void *GetPackEntryData(const PackEntry *entry) {
+    if (packData == NULL || entry == NULL) return NULL;
+
+    return packData + entry->offset;
+}
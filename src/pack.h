@@ -0,0 +1,72 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Packed asset archive (built by `make pack` from the assets/ folder)
+//
+// Layout: [PackHeader][PackEntry * entryCount][aligned entry data...]
+// The table of contents is sorted by name so lookups are a binary search, and
+// every entry holds pre-decoded data (RGBA pixels or PCM samples) ready to be
+// uploaded without any PNG/MP3 decoding at runtime. Archives built with --palette also hold
+// the shared palette (PACK_PALETTE_NAME) and, for every image, its palette indices stored
+// column-major under the image path plus PACK_INDEXED_SUFFIX, ready to be used in place as
+// the indices of an IndexedImage (palette.h). Version 2 added the palette entry types, so
+// older readers reject these archives instead of skipping entries they don't know.
+#define PACK_MAGIC          "MRPK"
+#define PACK_VERSION        2
+#define PACK_ALIGNMENT      64       // Alignment of entry data inside the archive
+#define PACK_NAME_SIZE      40       // Maximum asset path length (including terminator)
+#define ASSET_PACK_FILE     "assets.pak"
+#define PACK_PALETTE_NAME   "palette"
+#define PACK_INDEXED_SUFFIX ".pal8"
+#define PACK_PALETTE_COLORS 256      // Colors of a palette entry, in use or not (PALETTE_COLORS)
+#define PACK_IMAGE_FORMAT   7        // Format of every image entry (raylib PIXELFORMAT_UNCOMPRESSED_R8G8B8A8)
+
+// Entry types
+typedef enum {
+    PACK_ENTRY_IMAGE = 1,   // Decoded image pixels
+    PACK_ENTRY_WAVE,        // Decoded wave samples
+    PACK_ENTRY_PALETTE,     // Palette colors (R8G8B8A8)
+    PACK_ENTRY_INDEXED      // Palette indices of an image (column-major)
+} PackEntryType;
+
+// Archive header
+typedef struct {
+    char magic[4];          // PACK_MAGIC
+    uint32_t version;       // PACK_VERSION
+    uint32_t entryCount;    // Number of entries in the table of contents
+    uint32_t tocOffset;     // Offset of the table of contents
+    uint64_t fileSize;      // Total archive size, used to validate the file
+    uint64_t reserved;
+} PackHeader;
+
+// Table of contents entry
+typedef struct {
+    char name[PACK_NAME_SIZE]; // Asset path as used by the game (lookup key)
+    uint32_t type;          // PackEntryType
+    uint32_t offset;        // Offset of the data (multiple of PACK_ALIGNMENT)
+    uint32_t size;          // Data size in bytes
+    uint32_t width;         // Image: width in pixels / Wave: frame count / Palette: colors in use
+    uint32_t height;        // Image: height in pixels / Wave: sample rate
+    uint16_t format;        // Image: raylib PixelFormat / Wave: sample size in bits
+    uint16_t channels;      // Wave: channel count
+} PackEntry;
+
+// Memory-map an asset archive (only one archive can be open at a time)
+bool OpenAssetPack(const char *fileName);
+
+// Unmap the open archive, any pointer returned by GetPackEntryData becomes invalid
+void CloseAssetPack(void);
+
+// Check if an archive is currently open
+bool IsAssetPackOpen(void);
+
+// Find an entry by asset path, returns NULL if there is no archive or no such entry
+const PackEntry *FindPackEntry(const char *name);
+
+// Get a pointer to the (read-only, mapped) data of an entry
+const void *GetPackEntryData(const PackEntry *entry);
+
+#endif // PACK_H
@@ -0,0 +1,279 @@
+#include "palette.h"
+#include "pack.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Distinct color of the images and the number of texels using it
+typedef struct {
+    Color color;
+    unsigned int count;
+} ColorCount;
+
+// Box of the median cut: colors [first, last) of the sorted color list
+typedef struct {
+    int first;
+    int last;
+    int channel;            // Channel with the widest range (0..3 = r, g, b, a)
+    int range;              // Its range, 0 if the box can't be split
+} ColorBox;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Channel of a color (0..3 = r, g, b, a)
+static inline int ColorChannel(Color color, int channel) {
+    switch (channel) {
+        case 0: return color.r;
+        case 1: return color.g;
+        case 2: return color.b;
+        default: return color.a;
+    }
+}
+
+// Color as one integer, every channel included (total order of the colors)
+static inline unsigned int PackColor(Color color) {
+    return ((unsigned int)color.r << 24) | ((unsigned int)color.g << 16) | ((unsigned int)color.b << 8) | color.a;
+}
+
+// Order two colors by one channel, then by the whole color (no ties, so the result doesn't
+// depend on the qsort implementation)
+static int CompareOnChannel(const void *a, const void *b, int channel) {
+    Color ca = ((const ColorCount *)a)->color;
+    Color cb = ((const ColorCount *)b)->color;
+    int diff = ColorChannel(ca, channel) - ColorChannel(cb, channel);
+    if (diff != 0) return diff;
+
+    unsigned int pa = PackColor(ca);
+    unsigned int pb = PackColor(cb);
+    return (pa > pb) - (pa < pb);
+}
+
+static int CompareRed(const void *a, const void *b) { return CompareOnChannel(a, b, 0); }
+static int CompareGreen(const void *a, const void *b) { return CompareOnChannel(a, b, 1); }
+static int CompareBlue(const void *a, const void *b) { return CompareOnChannel(a, b, 2); }
+static int CompareAlpha(const void *a, const void *b) { return CompareOnChannel(a, b, 3); }
+
+// Find the widest channel of a box
+static void MeasureBox(const ColorCount *colors, ColorBox *box) {
+    int low[4] = { 255, 255, 255, 255 };
+    int high[4] = { 0, 0, 0, 0 };
+
+    for (int i = box->first; i < box->last; i++) {
+        for (int channel = 0; channel < 4; channel++) {
+            int value = ColorChannel(colors[i].color, channel);
+            if (value < low[channel]) low[channel] = value;
+            if (value > high[channel]) high[channel] = value;
+        }
+    }
+
+    box->channel = 0;
+    box->range = 0;
+    if (box->last - box->first < 2) return;
+
+    for (int channel = 0; channel < 4; channel++) {
+        if (high[channel] - low[channel] > box->range) {
+            box->range = high[channel] - low[channel];
+            box->channel = channel;
+        }
+    }
+}
+
+// Split a box at the weighted median of its widest channel, the upper half goes to upper
+static void SplitBox(ColorCount *colors, ColorBox *box, ColorBox *upper) {
+    static int (*const compare[4])(const void *, const void *) = { CompareRed, CompareGreen, CompareBlue, CompareAlpha };
+    qsort(colors + box->first, box->last - box->first, sizeof(ColorCount), compare[box->channel]);
+
+    unsigned long long total = 0;
+    for (int i = box->first; i < box->last; i++) total += colors[i].count;
+
+    // First color past half of the texels (both halves keep at least one color)
+    unsigned long long sum = 0;
+    int split = box->first + 1;
+    for (int i = box->first; i < box->last - 1; i++) {
+        sum += colors[i].count;
+        split = i + 1;
+        if (2 * sum >= total) break;
+    }
+
+    upper->first = split;
+    upper->last = box->last;
+    box->last = split;
+    MeasureBox(colors, box);
+    MeasureBox(colors, upper);
+}
+
+// Squared distance between two colors (alpha included)
+static inline int ColorDistance(Color a, Color b) {
+    int dr = a.r - b.r;
+    int dg = a.g - b.g;
+    int db = a.b - b.b;
+    int da = a.a - b.a;
+    return dr*dr + dg*dg + db*db + da*da;
+}
+
+// Index of the palette color closest to a color
+static int NearestColor(const Palette *palette, Color color) {
+    if (color.a == 0) return PALETTE_TRANSPARENT;
+
+    int best = PALETTE_TRANSPARENT;
+    int bestDistance = 0x7fffffff;
+    for (int i = 0; i < palette->count; i++) {
+        if (i == PALETTE_TRANSPARENT) continue;
+
+        int distance = ColorDistance(palette->colors[i], color);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Build a palette for a set of images
+bool BuildPalette(const Image *const *images, int count, Palette *palette) {
+    size_t total = 0;
+    for (int i = 0; i < count; i++) total += (size_t)images[i]->width * images[i]->height;
+
+    ColorCount *colors = (ColorCount *)malloc((total > 0 ? total : 1) * sizeof(ColorCount));
+    if (colors == NULL) return false;
+
+    // Every visible texel, then the distinct colors with their counts
+    int colorCount = 0;
+    for (int i = 0; i < count; i++) {
+        const Color *texels = (const Color *)images[i]->data;
+        int texelCount = images[i]->width * images[i]->height;
+
+        for (int t = 0; t < texelCount; t++) {
+            if (texels[t].a != 0) colors[colorCount++] = (ColorCount){ texels[t], 1 };
+        }
+    }
+
+    qsort(colors, colorCount, sizeof(ColorCount), CompareRed);
+
+    int distinct = 0;
+    for (int i = 0; i < colorCount; i++) {
+        if (distinct > 0 && PackColor(colors[distinct - 1].color) == PackColor(colors[i].color)) {
+            colors[distinct - 1].count++;
+        } else {
+            colors[distinct++] = colors[i];
+        }
+    }
+
+    // Median cut: split the widest box until every palette entry has one
+    ColorBox boxes[PALETTE_COLORS - 1];
+    int boxCount = 0;
+    if (distinct > 0) {
+        boxes[0] = (ColorBox){ 0, distinct, 0, 0 };
+        MeasureBox(colors, &boxes[0]);
+        boxCount = 1;
+    }
+
+    while (boxCount < PALETTE_COLORS - 1) {
+        int widest = -1;
+        for (int i = 0; i < boxCount; i++) {
+            if (boxes[i].range > 0 && (widest < 0 || boxes[i].range > boxes[widest].range)) widest = i;
+        }
+        if (widest < 0) break;
+
+        SplitBox(colors, &boxes[widest], &boxes[boxCount]);
+        boxCount++;
+    }
+
+    // Each box becomes the average of its texels
+    palette->colors[PALETTE_TRANSPARENT] = BLANK;
+    for (int i = 0; i < boxCount; i++) {
+        unsigned long long sum[4] = { 0, 0, 0, 0 };
+        unsigned long long weight = 0;
+
+        for (int c = boxes[i].first; c < boxes[i].last; c++) {
+            for (int channel = 0; channel < 4; channel++) {
+                sum[channel] += (unsigned long long)ColorChannel(colors[c].color, channel) * colors[c].count;
+            }
+            weight += colors[c].count;
+        }
+
+        Color average;
+        average.r = (unsigned char)((sum[0] + weight / 2) / weight);
+        average.g = (unsigned char)((sum[1] + weight / 2) / weight);
+        average.b = (unsigned char)((sum[2] + weight / 2) / weight);
+        average.a = (unsigned char)((sum[3] + weight / 2) / weight);
+        palette->colors[i + 1] = average;
+    }
+    for (int i = boxCount + 1; i < PALETTE_COLORS; i++) palette->colors[i] = BLANK;
+    palette->count = boxCount + 1;
+
+    free(colors);
+    return true;
+}
+
+// Quantize an image to a palette
+IndexedImage QuantizeImage(const Image *image, const Palette *palette) {
+    IndexedImage indexed = { 0 };
+    unsigned char *indices = (unsigned char *)malloc((size_t)image->width * image->height);
+    if (indices == NULL) return indexed;
+
+    const Color *texels = (const Color *)image->data;
+    for (int x = 0; x < image->width; x++) {
+        for (int y = 0; y < image->height; y++) {
+            indices[x * image->height + y] = (unsigned char)NearestColor(palette, texels[y * image->width + x]);
+        }
+    }
+
+    indexed.indices = indices;
+    indexed.width = image->width;
+    indexed.height = image->height;
+    return indexed;
+}
+
+// Free an image made by QuantizeImage
+void UnloadIndexedImage(IndexedImage *image) {
+    free((void *)image->indices);
+    image->indices = NULL;
+    image->width = 0;
+    image->height = 0;
+}
+
+// Palette of the open asset archive
+bool LoadPackPalette(Palette *palette) {
+    const PackEntry *entry = FindPackEntry(PACK_PALETTE_NAME);
+    if (entry == NULL || entry->type != PACK_ENTRY_PALETTE) return false;
+
+    memcpy(palette->colors, GetPackEntryData(entry), sizeof(palette->colors));
+    palette->count = (int)entry->width;
+    return true;
+}
+
+// Indices of an image of the open asset archive
+IndexedImage GetPackIndexedImage(const char *imagePath) {
+    IndexedImage image = { 0 };
+    char name[PACK_NAME_SIZE];
+    if (strlen(imagePath) + strlen(PACK_INDEXED_SUFFIX) >= PACK_NAME_SIZE) return image;
+
+    strcpy(name, imagePath);
+    strcat(name, PACK_INDEXED_SUFFIX);
+    const PackEntry *entry = FindPackEntry(name);
+    if (entry == NULL || entry->type != PACK_ENTRY_INDEXED) return image;
+
+    image.indices = (const unsigned char *)GetPackEntryData(entry);
+    image.width = (int)entry->width;
+    image.height = (int)entry->height;
+    return image;
+}
+
+// Shade the palette at every level
+void BuildColormaps(Colormaps *colormaps, const Palette *palette, const ShadeTable *shades) {
+    for (int level = 0; level < SHADE_LEVELS; level++) {
+        const unsigned char *ramp = shades->ramps[level];
+
+        for (int i = 0; i < PALETTE_COLORS; i++) {
+            Color color = palette->colors[i];
+            colormaps->colors[level][i] = (Color){ ramp[color.r], ramp[color.g], ramp[color.b], color.a };
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include "raylib.h"
+#include "shade.h"
+#include <stdbool.h>
+
+// Palettized textures for the software renderer: the texels of every texture are quantized to
+// one shared palette and stored as 8-bit indices, column-major so a wall or sprite column is a
+// contiguous run of bytes. Shading goes through colormaps (the palette at every shade level),
+// so a shaded texel is a single lookup. mkpack --palette quantizes the images at build time and
+// writes the palette and the indices to the asset archive, where they are used in place.
+// Only the software renderer uses them (the game draws RGBA textures on the GPU). One set of
+// colormaps serves every texture, so the indices take less memory than RGBA texels once the
+// textures hold more than about 22K texels (renderbench --palette reports both).
+
+#define PALETTE_COLORS      256     // Colors of a palette (8-bit indices)
+#define PALETTE_TRANSPARENT 0       // Index of fully transparent texels (BLANK)
+
+// Shared palette
+typedef struct {
+    Color colors[PALETTE_COLORS];
+    int count;                      // Colors in use, PALETTE_TRANSPARENT included
+} Palette;
+
+// Texture quantized to a palette: the indices of column x are indices[x * height ... x * height + height - 1]
+typedef struct {
+    const unsigned char *indices;
+    int width;
+    int height;
+} IndexedImage;
+
+// Palette colors at every shade level of a shade table: colors[level][index]
+typedef struct {
+    Color colors[SHADE_LEVELS][PALETTE_COLORS];
+} Colormaps;
+
+// Build a palette for a set of R8G8B8A8 images (median cut over their colors, weighted by how
+// many texels use each one; fully transparent texels all go to PALETTE_TRANSPARENT). The result
+// only depends on the texels, returns false if there is no memory
+bool BuildPalette(const Image *const *images, int count, Palette *palette);
+
+// Quantize an R8G8B8A8 image to the nearest palette colors (indices is NULL if there is no memory)
+IndexedImage QuantizeImage(const Image *image, const Palette *palette);
+
+// Free an image made by QuantizeImage
+void UnloadIndexedImage(IndexedImage *image);
+
+// Palette stored in the open asset archive (pack.h) by mkpack --palette, returns false if there
+// is none
+bool LoadPackPalette(Palette *palette);
+
+// Indices of an image stored in the open asset archive by mkpack --palette, mapped in place
+// (valid while the archive stays open, not to be unloaded). indices is NULL if there are none
+IndexedImage GetPackIndexedImage(const char *imagePath);
+
+// Shade the palette through the ramps of a shade table
+void BuildColormaps(Colormaps *colormaps, const Palette *palette, const ShadeTable *shades);
+
+#endif // PALETTE_H
@@ -0,0 +1,273 @@
+#include "profiler.h"
+#include "raylib.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define PROFILE_RING_MASK       (PROFILE_RING_SIZE - 1)
+#define PROFILE_REFRESH_FRAMES  30       // Frames between two refreshes of the overlay statistics
+#define CSV_DRAIN_INTERVAL_NS   20000000 // Time the CSV writer sleeps between two drains (20 ms)
+
+// Names shown by the overlay and used as CSV columns
+static const char *stageNames[PROFILE_STAGE_COUNT] = {
+    "MovePlayer", "UpdateEnemies", "PlayerAttacks", "Raycasting", "Walls", "Sprites", "HUD", "EndDrawing", "Frame"
+};
+static const char *stageColumns[PROFILE_STAGE_COUNT] = {
+    "move_player_ms", "update_enemies_ms", "player_attacks_ms", "raycasting_ms", "walls_ms", "sprites_ms",
+    "hud_ms", "end_drawing_ms", "frame_ms"
+};
+static const char *counterNames[PROFILE_COUNTER_COUNT] = { "Rays", "DDA steps", "Sprites", "Draw calls" };
+static const char *counterColumns[PROFILE_COUNTER_COUNT] = { "rays", "dda_steps", "sprites_drawn", "draw_calls" };
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+
+// Current frame (main thread, except the simulation stages: with the game pipelined they are
+// timed on the simulation thread, so stage times are added and collected atomically)
+static uint64_t stageStart[PROFILE_STAGE_COUNT];
+static _Atomic uint64_t stageTime[PROFILE_STAGE_COUNT];
+static uint32_t frameCounters[PROFILE_COUNTER_COUNT];
+static uint64_t lastFrameEnd = 0;
+static uint32_t frameNumber = 0;
+
+// Single-producer single-consumer ring: the main thread publishes frames by advancing the
+// head, the CSV writer consumes them by advancing the tail
+static ProfileFrame ring[PROFILE_RING_SIZE];
+static atomic_uint ringHead;
+static atomic_uint ringTail;
+static uint32_t droppedFrames = 0;           // Frames lost because the CSV writer fell a ring behind
+
+// Overlay
+static bool overlayVisible = false;
+static int framesSinceRefresh = PROFILE_REFRESH_FRAMES;
+static float statMin[PROFILE_STAGE_COUNT];
+static float statAvg[PROFILE_STAGE_COUNT];
+static float statP99[PROFILE_STAGE_COUNT];
+static float counterAvg[PROFILE_COUNTER_COUNT];
+static int statFrames = 0;
+
+// CSV export
+static FILE *csvFile = NULL;
+static pthread_t csvThread;
+static bool csvRunning = false;
+static atomic_bool csvStopRequested;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Monotonic high-resolution clock in nanoseconds
+static uint64_t ReadTimer(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Sort helper for the percentiles
+static int CompareFloats(const void *a, const void *b) {
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Recompute min/avg/p99 over the last PROFILE_WINDOW frames of the ring (main thread)
+static void RefreshStatistics(void) {
+    static float values[PROFILE_WINDOW];
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_relaxed);
+    int count = (head < PROFILE_WINDOW) ? (int)head : PROFILE_WINDOW;
+
+    statFrames = count;
+    if (count == 0) return;
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        float sum = 0.0f;
+        for (int i = 0; i < count; i++) {
+            values[i] = ring[(head - 1 - i) & PROFILE_RING_MASK].stageMs[stage];
+            sum += values[i];
+        }
+        qsort(values, count, sizeof(float), CompareFloats);
+
+        int p99Index = (count * 99 + 99) / 100 - 1;
+        statMin[stage] = values[0];
+        statAvg[stage] = sum / count;
+        statP99[stage] = values[p99Index];
+    }
+
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+        double sum = 0.0;
+        for (int i = 0; i < count; i++) {
+            sum += ring[(head - 1 - i) & PROFILE_RING_MASK].counters[counter];
+        }
+        counterAvg[counter] = (float)(sum / count);
+    }
+}
+
+// Write every published frame not written yet (CSV writer thread)
+static void DrainCsvRows(void) {
+    uint32_t tail = atomic_load_explicit(&ringTail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_acquire);
+
+    for (; tail != head; tail++) {
+        const ProfileFrame *frame = &ring[tail & PROFILE_RING_MASK];
+
+        fprintf(csvFile, "%u", frame->frame);
+        for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) fprintf(csvFile, ",%.4f", frame->stageMs[stage]);
+        for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) fprintf(csvFile, ",%u", frame->counters[counter]);
+        fputc('\n', csvFile);
+    }
+
+    // Hand the slots back to the producer
+    atomic_store_explicit(&ringTail, tail, memory_order_release);
+}
+
+// CSV writer thread: drain the ring periodically so the main thread never waits on disk
+static void *CsvWriterThread(void *arg) {
+    struct timespec interval = { 0, CSV_DRAIN_INTERVAL_NS };
+
+    while (!atomic_load(&csvStopRequested)) {
+        DrainCsvRows();
+        nanosleep(&interval, NULL);
+    }
+
+    DrainCsvRows();
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start timing a stage
+void ProfileBegin(ProfileStage stage) {
+    TraceBegin(stageNames[stage]);
+    stageStart[stage] = ReadTimer();
+}
+
+// Stop timing a stage
+void ProfileEnd(ProfileStage stage) {
+    atomic_fetch_add_explicit(&stageTime[stage], ReadTimer() - stageStart[stage], memory_order_relaxed);
+    TraceEnd(stageNames[stage]);
+}
+
+// Add to a counter of the current frame
+void ProfileCount(ProfileCounter counter, int amount) {
+    frameCounters[counter] += (uint32_t)amount;
+}
+
+// Close the current frame
+void ProfileEndFrame(void) {
+    uint64_t now = ReadTimer();
+    uint64_t times[PROFILE_STAGE_COUNT];
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        times[stage] = atomic_exchange_explicit(&stageTime[stage], 0, memory_order_relaxed);
+    }
+    if (lastFrameEnd != 0) times[PROFILE_FRAME] = now - lastFrameEnd;
+    lastFrameEnd = now;
+
+    uint32_t head = atomic_load_explicit(&ringHead, memory_order_relaxed);
+
+    // Never overwrite a frame the CSV writer hasn't read yet
+    if (csvRunning && head - atomic_load_explicit(&ringTail, memory_order_acquire) >= PROFILE_RING_SIZE) {
+        droppedFrames++;
+    } else {
+        ProfileFrame *frame = &ring[head & PROFILE_RING_MASK];
+        frame->frame = frameNumber;
+        for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) frame->stageMs[stage] = (float)(times[stage] * 1e-6);
+        for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) frame->counters[counter] = frameCounters[counter];
+
+        atomic_store_explicit(&ringHead, head + 1, memory_order_release);
+    }
+
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) frameCounters[counter] = 0;
+    frameNumber++;
+
+    // The statistics are only needed (and only refreshed) while the overlay is visible
+    if (overlayVisible && ++framesSinceRefresh >= PROFILE_REFRESH_FRAMES) {
+        RefreshStatistics();
+        framesSinceRefresh = 0;
+    }
+}
+
+// Show or hide the overlay
+void ToggleProfilerOverlay(void) {
+    overlayVisible = !overlayVisible;
+    framesSinceRefresh = PROFILE_REFRESH_FRAMES;
+}
+
+// Draw the overlay
+void DrawProfilerOverlay(void) {
+    if (!overlayVisible) return;
+
+    const int fontSize = 10;
+    const int lineHeight = 12;
+    int x = 10;
+    int y = 10;
+
+    DrawRectangle(x - 5, y - 5, 330, (PROFILE_STAGE_COUNT + PROFILE_COUNTER_COUNT + 3) * lineHeight + 10,
+                  (Color){ 0, 0, 0, 180 });
+
+    DrawText(TextFormat("Last %d frames (ms)      min      avg      p99", statFrames), x, y, fontSize, YELLOW);
+    y += lineHeight;
+
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+        DrawText(stageNames[stage], x, y, fontSize, WHITE);
+        DrawText(TextFormat("%8.3f %8.3f %8.3f", statMin[stage], statAvg[stage], statP99[stage]), x + 150, y, fontSize, WHITE);
+        y += lineHeight;
+    }
+
+    y += lineHeight;
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) {
+        DrawText(TextFormat("%s: %.0f/frame", counterNames[counter], counterAvg[counter]), x, y, fontSize, LIGHTGRAY);
+        y += lineHeight;
+    }
+
+    if (droppedFrames > 0) DrawText(TextFormat("Dropped frames: %u", droppedFrames), x, y, fontSize, RED);
+}
+
+// Start the CSV export
+bool StartProfileCsv(const char *fileName) {
+    if (csvRunning) return false;
+
+    csvFile = fopen(fileName, "w");
+    if (csvFile == NULL) {
+        printf("Error creating profile file: %s\n", fileName);
+        return false;
+    }
+
+    fprintf(csvFile, "frame");
+    for (int stage = 0; stage < PROFILE_STAGE_COUNT; stage++) fprintf(csvFile, ",%s", stageColumns[stage]);
+    for (int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++) fprintf(csvFile, ",%s", counterColumns[counter]);
+    fputc('\n', csvFile);
+
+    // Only frames from now on are exported
+    atomic_store(&ringTail, atomic_load(&ringHead));
+    atomic_store(&csvStopRequested, false);
+
+    if (pthread_create(&csvThread, NULL, CsvWriterThread, NULL) != 0) {
+        printf("Error starting profile writer thread\n");
+        fclose(csvFile);
+        csvFile = NULL;
+        return false;
+    }
+
+    csvRunning = true;
+    return true;
+}
+
+// Stop the CSV export
+void StopProfileCsv(void) {
+    if (!csvRunning) return;
+
+    atomic_store(&csvStopRequested, true);
+    pthread_join(csvThread, NULL);
+    csvRunning = false;
+
+    fclose(csvFile);
+    csvFile = NULL;
+
+    if (droppedFrames > 0) printf("Profile: %u frames dropped (CSV writer too slow)\n", droppedFrames);
+}
@@ -0,0 +1,70 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Profiler configuration
+#define PROFILE_RING_SIZE   1024     // Frames kept in the ring buffer (power of two)
+#define PROFILE_WINDOW      240      // Frames summarized by the overlay (min/avg/p99)
+
+// Timed stages of a frame
+typedef enum {
+    PROFILE_MOVE_PLAYER = 0,
+    PROFILE_UPDATE_ENEMIES,
+    PROFILE_PLAYER_ATTACKS,
+    PROFILE_RAYCASTING,      // Wall traversal pass (rays only, no drawing)
+    PROFILE_WALLS,           // Wall shading and drawing pass
+    PROFILE_SPRITES,
+    PROFILE_HUD,
+    PROFILE_END_DRAWING,
+    PROFILE_FRAME,           // Whole frame, from one ProfileEndFrame to the next
+    PROFILE_STAGE_COUNT
+} ProfileStage;
+
+// Per-frame counters
+typedef enum {
+    PROFILE_RAYS = 0,        // Rays cast
+    PROFILE_DDA_STEPS,       // Grid cells visited by the DDA
+    PROFILE_SPRITES_DRAWN,   // Sprites with at least one visible stripe
+    PROFILE_DRAW_CALLS,      // raylib draw calls issued by the 3D view and the HUD
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+// Measurements of one frame (stages run several times per frame, e.g. one MovePlayer per
+// simulation step, add up)
+typedef struct {
+    uint32_t frame;                                  // Frame number
+    float stageMs[PROFILE_STAGE_COUNT];              // Time spent in each stage (milliseconds)
+    uint32_t counters[PROFILE_COUNTER_COUNT];
+} ProfileFrame;
+
+// Time the statement or block that follows (don't leave it with break/return/goto)
+#define PROFILE_SCOPE(stage) \
+    for (int profileScope_ = (ProfileBegin(stage), 0); profileScope_ == 0; ProfileEnd(stage), profileScope_ = 1)
+
+// Start timing a stage (stages also show up in the trace timeline when tracing)
+void ProfileBegin(ProfileStage stage);
+
+// Stop timing a stage and add the elapsed time to the current frame
+void ProfileEnd(ProfileStage stage);
+
+// Add to a counter of the current frame
+void ProfileCount(ProfileCounter counter, int amount);
+
+// Close the current frame and push it to the ring buffer
+void ProfileEndFrame(void);
+
+// Show or hide the on-screen overlay
+void ToggleProfilerOverlay(void);
+
+// Draw the overlay (if visible), must be called between BeginDrawing and EndDrawing
+void DrawProfilerOverlay(void);
+
+// Write one CSV row per frame to a file, from a background thread that drains the ring buffer
+bool StartProfileCsv(const char *fileName);
+
+// Write the pending rows and close the CSV file
+void StopProfileCsv(void);
+
+#endif // PROFILER_H
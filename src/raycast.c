@@ -0,0 +1,532 @@
+#include "raycast.h"
+#include "utils.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DISTANCE_MARGIN     0.01f   // Hits solved without the DDA stay this much closer than maxDistance
+#define PANORAMA_DISTANCE   2.0f    // Reach of the panorama rays (times maxDistance, covers the screen edges)
+
+// Finds the hit of one column and stores it in the buffer, returns the DDA steps
+typedef int (*ColumnTracer)(ColumnBuffer *buffer, int x, const Maze *maze, const RayCamera *camera, float maxDistance);
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Distance along the camera direction to the face of a cell hit by a ray (the DDA and the
+// coherent traversal share it so both give the same bits)
+static inline float FaceDistance(int mapX, int mapY, int side, Vector2 origin, Vector2 rayDir) {
+    if (side == 0) {
+        int stepX = (rayDir.x < 0) ? -1 : 1;
+        return (mapX - origin.x + (1 - stepX) / 2) / rayDir.x;
+    } else {
+        int stepY = (rayDir.y < 0) ? -1 : 1;
+        return (mapY - origin.y + (1 - stepY) / 2) / rayDir.y;
+    }
+}
+
+// Direction of the ray through a screen column
+static inline Vector2 ColumnRayDir(const RayCamera *camera, int x, float screenWidth) {
+    float cameraX = 2.0f * x / screenWidth - 1.0f;
+    return (Vector2){ camera->dir.x + camera->plane.x * cameraX, camera->dir.y + camera->plane.y * cameraX };
+}
+
+// Cells that stop a ray: walls and everything outside the maze
+static inline bool IsSolidCell(const Maze *maze, int x, int y) {
+    return (x < 0) || (x >= MAZE_WIDTH) || (y < 0) || (y >= MAZE_HEIGHT) || (maze->grid[y][x] == CELL_WALL);
+}
+
+// Cast the ray of one column with the DDA and store its hit, returns the DDA steps
+static int CastColumn(ColumnBuffer *buffer, int x, const Maze *maze, const RayCamera *camera, float maxDistance) {
+    RayHit hit = CastRay(maze, camera->position, ColumnRayDir(camera, x, (float)buffer->width), maxDistance);
+
+    buffer->depth[x] = hit.distance;
+    buffer->cellX[x] = hit.mapX;
+    buffer->cellY[x] = hit.mapY;
+    buffer->side[x] = (unsigned char)hit.side;
+
+    return hit.steps;
+}
+
+// Check if the rays of two columns hit the same face of a solid cell, close enough that the
+// DDA of every ray in between reaches it too
+static bool IsSameFace(const ColumnBuffer *buffer, int a, int b, const Maze *maze, float maxDistance) {
+    if (buffer->cellX[a] != buffer->cellX[b] || buffer->cellY[a] != buffer->cellY[b] || buffer->side[a] != buffer->side[b]) {
+        return false;
+    }
+
+    // The DDA gives up around maxDistance (the depth along a face is linear, so the rays in
+    // between are no farther than the two ends)
+    float limit = maxDistance - DISTANCE_MARGIN;
+    return (buffer->depth[a] < limit) && (buffer->depth[b] < limit) && IsSolidCell(maze, buffer->cellX[a], buffer->cellY[a]);
+}
+
+// Fill the columns strictly between a and b, whose rays hit the same face. The rays on both
+// ends only crossed empty cells and the face belongs to a single cell, so no wall can be
+// inside the triangle they form with the camera: every ray in between hits that face
+static void FillFace(ColumnBuffer *buffer, int a, int b, const RayCamera *camera) {
+    float screenWidth = (float)buffer->width;
+    int mapX = buffer->cellX[a];
+    int mapY = buffer->cellY[a];
+    int side = buffer->side[a];
+
+    for (int x = a + 1; x < b; x++) {
+        buffer->depth[x] = FaceDistance(mapX, mapY, side, camera->position, ColumnRayDir(camera, x, screenWidth));
+        buffer->cellX[x] = mapX;
+        buffer->cellY[x] = mapY;
+        buffer->side[x] = (unsigned char)side;
+    }
+}
+
+// Resolve the columns strictly between a and b (both already traced): a run on one face is
+// filled analytically, otherwise the span is split at a new traced column. Returns the DDA steps
+static int TraceSpan(ColumnBuffer *buffer, int a, int b, const Maze *maze, const RayCamera *camera, float maxDistance,
+                     ColumnTracer tracer) {
+    if (b - a < 2) return 0;
+
+    if (IsSameFace(buffer, a, b, maze, maxDistance)) {
+        FillFace(buffer, a, b, camera);
+        return 0;
+    }
+
+    int middle = (a + b) / 2;
+    int steps = tracer(buffer, middle, maze, camera, maxDistance);
+    steps += TraceSpan(buffer, a, middle, maze, camera, maxDistance, tracer);
+    steps += TraceSpan(buffer, middle, b, maze, camera, maxDistance, tracer);
+    return steps;
+}
+
+// Trace every COHERENCE_SPAN columns, the spans in between are resolved by TraceSpan. Returns
+// the DDA steps
+static int TraceCoherent(ColumnBuffer *buffer, const Maze *maze, const RayCamera *camera, float maxDistance,
+                         ColumnTracer tracer) {
+    if (buffer->width <= 0) return 0;
+
+    int steps = tracer(buffer, 0, maze, camera, maxDistance);
+    for (int previous = 0, x = COHERENCE_SPAN; previous < buffer->width - 1; x += COHERENCE_SPAN) {
+        if (x > buffer->width - 1) x = buffer->width - 1;
+        steps += tracer(buffer, x, maze, camera, maxDistance);
+        steps += TraceSpan(buffer, previous, x, maze, camera, maxDistance, tracer);
+        previous = x;
+    }
+
+    return steps;
+}
+
+// Wall cells of one maze row as bits (bit x set for a wall)
+static unsigned short WallRow(const Maze *maze, int y) {
+    unsigned short row = 0;
+    for (int x = 0; x < MAZE_WIDTH; x++) {
+        if (maze->grid[y][x] == CELL_WALL) row |= (unsigned short)(1u << x);
+    }
+    return row;
+}
+
+// Check if a cache was traced from the camera position, for the same walls and screen (keys,
+// enemies and other cells rays go through don't matter)
+static bool IsCacheAtCamera(const ColumnCache *cache, const Maze *maze, const RayCamera *camera, float screenHeight,
+                            int textureWidth, float maxDistance) {
+    if (!cache->valid || (cache->position.x != camera->position.x) || (cache->position.y != camera->position.y) ||
+        (cache->screenHeight != screenHeight) || (cache->textureWidth != textureWidth) ||
+        (cache->maxDistance != maxDistance)) {
+        return false;
+    }
+
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        if (cache->walls[y] != WallRow(maze, y)) return false;
+    }
+    return true;
+}
+
+// Start a cache at the camera position, with an empty panorama
+static void ResetColumnCache(ColumnCache *cache, const Maze *maze, const RayCamera *camera, float screenHeight,
+                             int textureWidth, float maxDistance) {
+    cache->position = camera->position;
+    cache->screenHeight = screenHeight;
+    cache->textureWidth = textureWidth;
+    cache->maxDistance = maxDistance;
+    for (int y = 0; y < MAZE_HEIGHT; y++) cache->walls[y] = WallRow(maze, y);
+    memset(cache->panoramaCast, 0, sizeof(cache->panoramaCast));
+}
+
+// Cast ray i of the panorama, returns the DDA steps
+static int CastPanoramaRay(ColumnCache *cache, int i, const Maze *maze) {
+    double angle = i * (2.0 * PI / PANORAMA_RAYS);
+    Vector2 dir = { (float)cos(angle), (float)sin(angle) };
+    RayHit hit = CastRay(maze, cache->position, dir, PANORAMA_DISTANCE * cache->maxDistance);
+
+    cache->panoramaCast[i] = true;
+    cache->panoramaCellX[i] = hit.mapX;
+    cache->panoramaCellY[i] = hit.mapY;
+    cache->panoramaSide[i] = (unsigned char)hit.side;
+
+    return hit.steps;
+}
+
+// Trace one column from the panorama of the cache position: when the panorama rays around the
+// column ray hit the same face, the column ray hits it too (same reasoning as FillFace) and only
+// its distance is computed. Falls back to the DDA otherwise, returns the DDA steps
+static int TracePanoramaColumn(ColumnBuffer *buffer, int x, const Maze *maze, const RayCamera *camera, float maxDistance) {
+    ColumnCache *cache = buffer->cache;
+    Vector2 rayDir = ColumnRayDir(camera, x, (float)buffer->width);
+    int steps = 0;
+
+    // Panorama rays on both sides, one more on each side covers the error of FastAtan2
+    float angle = FastAtan2(rayDir.y, rayDir.x);
+    if (angle < 0.0f) angle += 2.0f * PI;
+    int i = (int)(angle * (PANORAMA_RAYS / (2.0f * PI)));
+    int a = (i - 1) & (PANORAMA_RAYS - 1);
+    int b = (i + 2) & (PANORAMA_RAYS - 1);
+
+    if (!cache->panoramaCast[a]) steps += CastPanoramaRay(cache, a, maze);
+    if (!cache->panoramaCast[b]) steps += CastPanoramaRay(cache, b, maze);
+
+    int mapX = cache->panoramaCellX[a];
+    int mapY = cache->panoramaCellY[a];
+    int side = cache->panoramaSide[a];
+
+    if (mapX == cache->panoramaCellX[b] && mapY == cache->panoramaCellY[b] && side == cache->panoramaSide[b] &&
+        IsSolidCell(maze, mapX, mapY)) {
+        float distance = FaceDistance(mapX, mapY, side, camera->position, rayDir);
+        if (distance < maxDistance - DISTANCE_MARGIN) {
+            buffer->depth[x] = distance;
+            buffer->cellX[x] = mapX;
+            buffer->cellY[x] = mapY;
+            buffer->side[x] = (unsigned char)side;
+            return steps;
+        }
+    }
+
+    return steps + CastColumn(buffer, x, maze, camera, maxDistance);
+}
+
+// Bytes taken by an array of the column buffer, rounded so the next one stays aligned
+static size_t AlignedArraySize(int count, size_t elementSize) {
+    size_t size = count * elementSize;
+    return (size + COLUMN_BUFFER_ALIGNMENT - 1) & ~(size_t)(COLUMN_BUFFER_ALIGNMENT - 1);
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Cast a ray through the maze grid
+RayHit CastRay(const Maze *maze, Vector2 origin, Vector2 rayDir, float maxDistance) {
+    RayHit result = { 0 };
+
+    // Current map position
+    int mapX = (int)origin.x;
+    int mapY = (int)origin.y;
+
+    // Length of ray from one side to next
+    float deltaDistX = fabsf(rayDir.x) < 0.00001f ? 1e30f : fabsf(1.0f / rayDir.x);
+    float deltaDistY = fabsf(rayDir.y) < 0.00001f ? 1e30f : fabsf(1.0f / rayDir.y);
+
+    // Calculate step and initial side distance
+    int stepX, stepY;
+    float sideDistX, sideDistY;
+
+    if (rayDir.x < 0) {
+        stepX = -1;
+        sideDistX = (origin.x - mapX) * deltaDistX;
+    } else {
+        stepX = 1;
+        sideDistX = (mapX + 1.0f - origin.x) * deltaDistX;
+    }
+
+    if (rayDir.y < 0) {
+        stepY = -1;
+        sideDistY = (origin.y - mapY) * deltaDistY;
+    } else {
+        stepY = 1;
+        sideDistY = (mapY + 1.0f - origin.y) * deltaDistY;
+    }
+
+    // DDA Algorithm
+    bool hit = false;
+    int side = 0;
+
+    while (!hit && (sideDistX < maxDistance || sideDistY < maxDistance)) {
+        result.steps++;
+
+        // Jump to next map square
+        if (sideDistX < sideDistY) {
+            sideDistX += deltaDistX;
+            mapX += stepX;
+            side = 0;
+        } else {
+            sideDistY += deltaDistY;
+            mapY += stepY;
+            side = 1;
+        }
+
+        // Walls and the map boundary stop the ray
+        if (mapX >= 0 && mapX < MAZE_WIDTH && mapY >= 0 && mapY < MAZE_HEIGHT) {
+            if (maze->grid[mapY][mapX] == CELL_WALL) hit = true;
+        } else {
+            hit = true;
+        }
+    }
+
+    // Exact distance to the wall along the camera direction
+    result.distance = FaceDistance(mapX, mapY, side, origin, rayDir);
+
+    result.mapX = mapX;
+    result.mapY = mapY;
+    result.side = side;
+
+    return result;
+}
+
+// Compute the rows and texture column of a wall column
+WallColumn ComputeWallColumn(const RayHit *hit, Vector2 origin, Vector2 rayDir, float screenHeight, int textureWidth) {
+    WallColumn column;
+
+    // Avoid division by zero
+    float perpWallDist = hit->distance;
+    if (perpWallDist < 0.1f) perpWallDist = 0.1f;
+
+    // Calculate height of the line to draw
+    int lineHeight = (int)(screenHeight / perpWallDist);
+
+    // Calculate start and end points
+    column.drawStart = -lineHeight / 2 + screenHeight / 2;
+    if (column.drawStart < 0) column.drawStart = 0;
+
+    column.drawEnd = lineHeight / 2 + screenHeight / 2;
+    if (column.drawEnd >= screenHeight) column.drawEnd = screenHeight - 1;
+
+    // Where the wall was hit, along the face
+    float wallX;
+    if (hit->side == 0) {
+        wallX = origin.y + perpWallDist * rayDir.y;
+    } else {
+        wallX = origin.x + perpWallDist * rayDir.x;
+    }
+    wallX -= floor(wallX);
+
+    // Texture x-coordinate (mirrored on two faces so textures aren't flipped)
+    column.texX = (int)(wallX * textureWidth);
+    if ((hit->side == 0 && rayDir.x > 0) || (hit->side == 1 && rayDir.y < 0)) {
+        column.texX = textureWidth - column.texX - 1;
+    }
+
+    return column;
+}
+
+// Transform a world point to camera space
+Vector2 TransformToCamera(Vector2 point, Vector2 origin, Vector2 dir, Vector2 plane) {
+    float relX = point.x - origin.x;
+    float relY = point.y - origin.y;
+
+    // Inverse of the camera matrix [plane dir]
+    float invDet = 1.0f / (plane.x * dir.y - dir.x * plane.y);
+
+    return (Vector2){
+        invDet * (dir.y * relX - dir.x * relY),
+        invDet * (-plane.y * relX + plane.x * relY)
+    };
+}
+
+// Build the camera of a frame
+RayCamera MakeRayCamera(Vector2 position, float angle, float planeScale) {
+    RayCamera camera;
+    camera.position = position;
+    FastSinCos(angle, &camera.dir.y, &camera.dir.x);
+    camera.plane = (Vector2){ -camera.dir.y * planeScale, camera.dir.x * planeScale };
+    camera.invDet = 1.0f / (camera.plane.x * camera.dir.y - camera.dir.x * camera.plane.y);
+    return camera;
+}
+
+// Transform a world point to camera space
+Vector2 TransformToRayCamera(const RayCamera *camera, Vector2 point) {
+    float relX = point.x - camera->position.x;
+    float relY = point.y - camera->position.y;
+
+    return (Vector2){
+        camera->invDet * (camera->dir.y * relX - camera->dir.x * relY),
+        camera->invDet * (-camera->plane.y * relX + camera->plane.x * relY)
+    };
+}
+
+// Make room for a frame of columns
+bool ReserveColumnBuffer(ColumnBuffer *buffer, int width) {
+    if (width <= buffer->capacity) {
+        buffer->width = width;
+        return true;
+    }
+
+    // Grow in steps of 64 columns so small resizes don't reallocate
+    int capacity = (width + 63) & ~63;
+    size_t floatSize = AlignedArraySize(capacity, sizeof(float));
+    size_t intSize = AlignedArraySize(capacity, sizeof(int));
+    size_t byteSize = AlignedArraySize(capacity, sizeof(unsigned char));
+
+    unsigned char *memory = aligned_alloc(COLUMN_BUFFER_ALIGNMENT, floatSize + 5 * intSize + byteSize);
+    if (memory == NULL) return false;
+
+    free(buffer->memory);
+    buffer->memory = memory;
+    if (buffer->cache != NULL) buffer->cache->valid = false;
+    buffer->capacity = capacity;
+    buffer->width = width;
+
+    buffer->depth = (float *)memory;               memory += floatSize;
+    buffer->cellX = (int *)memory;                 memory += intSize;
+    buffer->cellY = (int *)memory;                 memory += intSize;
+    buffer->texX = (int *)memory;                  memory += intSize;
+    buffer->drawStart = (int *)memory;             memory += intSize;
+    buffer->drawEnd = (int *)memory;               memory += intSize;
+    buffer->side = memory;
+
+    return true;
+}
+
+// Free the memory of a column buffer
+void FreeColumnBuffer(ColumnBuffer *buffer) {
+    free(buffer->memory);
+    free(buffer->cache);
+    memset(buffer, 0, sizeof(ColumnBuffer));
+}
+
+// Cast the ray of every column
+int TraceColumns(ColumnBuffer *buffer, const Maze *maze, const RayCamera *camera, float screenHeight,
+                 int textureWidth, float maxDistance, CastMode mode) {
+    float screenWidth = (float)buffer->width;
+    int ddaSteps = 0;
+
+    // The cache is allocated the first time it's used (without it the columns are traced coherently)
+    if (mode == CAST_CACHED && buffer->cache == NULL) buffer->cache = calloc(1, sizeof(ColumnCache));
+    ColumnCache *cache = (mode == CAST_CACHED) ? buffer->cache : NULL;
+
+    if (cache != NULL && IsCacheAtCamera(cache, maze, camera, screenHeight, textureWidth, maxDistance)) {
+        // Same view: the buffer already holds this frame
+        if (cache->width == buffer->width && cache->dir.x == camera->dir.x && cache->dir.y == camera->dir.y &&
+            cache->plane.x == camera->plane.x && cache->plane.y == camera->plane.y) {
+            return 0;
+        }
+
+        // Rotation only: the columns the coherent traversal would cast sample the panorama
+        ddaSteps = TraceCoherent(buffer, maze, camera, maxDistance, TracePanoramaColumn);
+    } else if (mode != CAST_DDA) {
+        if (cache != NULL) ResetColumnCache(cache, maze, camera, screenHeight, textureWidth, maxDistance);
+        ddaSteps = TraceCoherent(buffer, maze, camera, maxDistance, CastColumn);
+    } else {
+        for (int x = 0; x < buffer->width; x++) ddaSteps += CastColumn(buffer, x, maze, camera, maxDistance);
+    }
+
+    // Rows and texture column of every wall column
+    for (int x = 0; x < buffer->width; x++) {
+        RayHit hit = { buffer->depth[x], buffer->cellX[x], buffer->cellY[x], buffer->side[x], 0 };
+        WallColumn column = ComputeWallColumn(&hit, camera->position, ColumnRayDir(camera, x, screenWidth),
+                                              screenHeight, textureWidth);
+        buffer->texX[x] = column.texX;
+        buffer->drawStart[x] = column.drawStart;
+        buffer->drawEnd[x] = column.drawEnd;
+    }
+
+    // Remember the view of the results (other modes leave the cache stale)
+    if (cache != NULL) {
+        cache->valid = true;
+        cache->dir = camera->dir;
+        cache->plane = camera->plane;
+        cache->width = buffer->width;
+    } else if (buffer->cache != NULL) {
+        buffer->cache->valid = false;
+    }
+
+    return ddaSteps;
+}
+
+// Project a sprite to the screen
+bool ProjectSprite(Vector2 transform, CellType type, int screenWidth, int screenHeight, SpriteProjection *projection) {
+    float transformX = transform.x;
+    float transformY = transform.y;
+
+    // Behind the camera
+    if (transformY <= 0) return false;
+
+    // Calculate screen position
+    int spriteScreenX = (int)((screenWidth / 2) * (1 + transformX / transformY));
+
+    // Calculate sprite height
+    int spriteHeight = abs((int)(screenHeight / transformY));
+
+    // Specific adjustments by sprite type
+    if (type == CELL_KEY) {
+        spriteHeight /= 2; // Reduce height by half for keys
+    }
+    else if (type == CELL_EXIT) {
+        spriteHeight = (int)(spriteHeight * 1.3f); // Increase door size by 30%
+    }
+
+    // Same proportion as height to maintain shape
+    int spriteWidth = spriteHeight;
+    int drawStartY;
+    int drawEndY;
+
+    if (type == CELL_ENEMY) {
+        // For enemies: standard position, no special adjustments
+        drawStartY = -spriteHeight / 2 + screenHeight / 2;
+        if (drawStartY < 0) drawStartY = 0;
+
+        drawEndY = spriteHeight / 2 + screenHeight / 2 + 100;
+        if (drawEndY >= screenHeight) drawEndY = screenHeight - 1;
+    }
+    else if (type == CELL_EXIT) {
+        // For doors: adjust vertical position to be on the floor
+        drawEndY = screenHeight / 2 + spriteHeight / 2;
+        if (drawEndY >= screenHeight) drawEndY = screenHeight - 1;
+
+        drawStartY = drawEndY - spriteHeight;
+        if (drawStartY < 0) drawStartY = 0;
+    }
+    else {
+        // For keys: adjust vertical position to float at mid-height
+        drawStartY = -spriteHeight / 2 + screenHeight / 2;
+        if (drawStartY < 0) drawStartY = 0;
+
+        drawEndY = spriteHeight / 2 + screenHeight / 2;
+        if (drawEndY >= screenHeight) drawEndY = screenHeight - 1;
+    }
+
+    int drawStartX = -spriteWidth / 2 + spriteScreenX;
+    if (drawStartX < 0) drawStartX = 0;
+
+    int drawEndX = spriteWidth / 2 + spriteScreenX;
+    if (drawEndX >= screenWidth) drawEndX = screenWidth - 1;
+
+    projection->depth = transformY;
+    projection->drawStartX = drawStartX;
+    projection->drawEndX = drawEndX;
+    projection->drawStartY = drawStartY;
+    projection->drawEndY = drawEndY;
+
+    return true;
+}
+
+// Sort points from farthest to closest (insertion sort, stable)
+void SortByDistance(const Vector2 *points, int count, Vector2 viewer, int *order) {
+    float distances[MAX_SORTED_POINTS];
+    assert(count <= MAX_SORTED_POINTS);
+    if (count > MAX_SORTED_POINTS) return;
+
+    for (int i = 0; i < count; i++) {
+        float dx = points[i].x - viewer.x;
+        float dy = points[i].y - viewer.y;
+        distances[i] = dx*dx + dy*dy;
+    }
+
+    for (int i = 1; i < count; i++) {
+        int index = order[i];
+        int j = i - 1;
+
+        while (j >= 0 && distances[order[j]] < distances[index]) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = index;
+    }
+}
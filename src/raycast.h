@@ -0,0 +1,131 @@
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include "raylib.h"
+#include "maze.h"
+
+#define COLUMN_BUFFER_ALIGNMENT 64   // Alignment of every column array (a cache line, fits any SIMD width)
+#define COHERENCE_SPAN          16   // Columns between two DDA casts of the coherent traversal
+#define PANORAMA_RAYS           4096 // Rays around the camera in the panorama of a cached traversal (power of two)
+#define MAX_SORTED_POINTS       256  // Points SortByDistance orders at most
+
+#if MAZE_WIDTH > 16
+#error "ColumnCache.walls holds one maze row in 16 bits"
+#endif
+
+// How the traversal pass finds the wall of each column
+typedef enum {
+    CAST_DDA,               // One DDA walk per column (reference)
+    CAST_COHERENT,          // DDA at face boundaries only, runs of columns on one face are solved analytically
+    CAST_CACHED             // CAST_COHERENT, but a camera that doesn't move reuses the last results and a
+                            // camera that only rotates samples a panorama cast from its position
+} CastMode;
+
+// Result of casting one ray through the maze grid
+typedef struct {
+    float distance;         // Perpendicular distance to the wall (camera plane, no fisheye)
+    int mapX;               // Cell where the ray stopped
+    int mapY;
+    int side;               // Face that was hit: 0 = X face (east/west), 1 = Y face (north/south)
+    int steps;              // Grid cells visited by the DDA
+} RayHit;
+
+// Screen span of a textured wall column
+typedef struct {
+    int drawStart;          // First row (clamped to the screen)
+    int drawEnd;            // Last row (clamped to the screen)
+    int texX;               // Texture column
+} WallColumn;
+
+// Screen rectangle of a sprite (billboard)
+typedef struct {
+    float depth;            // Camera-space depth, compared against the z-buffer
+    int drawStartX;         // Columns [drawStartX, drawEndX) (clamped to the screen)
+    int drawEndX;
+    int drawStartY;         // Rows (clamped to the screen)
+    int drawEndY;
+} SpriteProjection;
+
+// Camera of one frame, computed once and shared by the wall and sprite passes
+typedef struct {
+    Vector2 position;
+    Vector2 dir;            // Unit view direction
+    Vector2 plane;          // Camera plane (half screen width), perpendicular to dir
+    float invDet;           // Inverse determinant of [plane dir], used by sprite transforms
+} RayCamera;
+
+// What the columns of a buffer were traced for, and the panorama of the rays cast around that
+// position (each panorama ray is cast the first time a column needs it)
+typedef struct {
+    bool valid;
+    Vector2 position;       // Camera of the traced columns
+    Vector2 dir;
+    Vector2 plane;
+    int width;
+    float screenHeight;
+    int textureWidth;
+    float maxDistance;
+    unsigned short walls[MAZE_HEIGHT];              // Wall cells the results belong to (bit x of row y)
+
+    bool panoramaCast[PANORAMA_RAYS];               // Rays of the panorama already cast
+    int panoramaCellX[PANORAMA_RAYS];               // Hit of each ray
+    int panoramaCellY[PANORAMA_RAYS];
+    unsigned char panoramaSide[PANORAMA_RAYS];
+} ColumnCache;
+
+// Per-column results of the wall traversal pass (G-buffer), one array per attribute so every
+// later pass (shading, sprites, effects) reads and vectorizes over just what it uses. The
+// memory persists between frames and only grows
+typedef struct {
+    int width;              // Columns in use
+    int capacity;           // Columns the arrays can hold
+    float *depth;           // Perpendicular distance to the wall (z-buffer of the sprites)
+    int *cellX;             // Cell where the ray stopped
+    int *cellY;
+    unsigned char *side;    // Face that was hit: 0 = X face (east/west), 1 = Y face (north/south)
+    int *texX;              // Texture column
+    int *drawStart;         // Rows of the wall (clamped to the screen)
+    int *drawEnd;
+    void *memory;           // Single block holding every array
+    ColumnCache *cache;     // State of CAST_CACHED (allocated on first use)
+} ColumnBuffer;
+
+// Cast a ray with the DDA algorithm until it hits a wall, leaves the maze or goes past maxDistance
+RayHit CastRay(const Maze *maze, Vector2 origin, Vector2 rayDir, float maxDistance);
+
+// Compute the rows and texture column of the wall hit by a ray
+WallColumn ComputeWallColumn(const RayHit *hit, Vector2 origin, Vector2 rayDir, float screenHeight, int textureWidth);
+
+// Transform a world point to camera space: x is the offset along the camera plane and y the
+// depth (points behind the camera have y <= 0)
+Vector2 TransformToCamera(Vector2 point, Vector2 origin, Vector2 dir, Vector2 plane);
+
+// Camera looking along an angle, planeScale is tan(FOV/2) (uses the fast math of utils.h)
+RayCamera MakeRayCamera(Vector2 position, float angle, float planeScale);
+
+// TransformToCamera with the camera matrix already inverted
+Vector2 TransformToRayCamera(const RayCamera *camera, Vector2 point);
+
+// Project a sprite already transformed to camera space (keys float at half size, exit doors
+// stand on the floor 30% larger), returns false if the sprite is behind the camera
+bool ProjectSprite(Vector2 transform, CellType type, int screenWidth, int screenHeight, SpriteProjection *projection);
+
+// Make room for a frame of width columns (memory is only reallocated to grow), returns false
+// if it can't be allocated
+bool ReserveColumnBuffer(ColumnBuffer *buffer, int width);
+
+// Free the memory of a column buffer
+void FreeColumnBuffer(ColumnBuffer *buffer);
+
+// Traversal pass: cast the ray of every column of the buffer and store its hit, rows and
+// texture column (no drawing), returns the DDA steps taken. Every mode gives the same result
+int TraceColumns(ColumnBuffer *buffer, const Maze *maze, const RayCamera *camera, float screenHeight,
+                 int textureWidth, float maxDistance, CastMode mode);
+
+// Sort points from farthest to closest to the viewer (painter's order)
+// order holds a permutation of 0..count-1 and is sorted in place: passing last frame's order
+// makes the sort almost linear since sprites barely move between frames. count must not
+// exceed MAX_SORTED_POINTS (asserted, builds without asserts leave order as it is)
+void SortByDistance(const Vector2 *points, int count, Vector2 viewer, int *order);
+
+#endif // RAYCAST_H
@@ -0,0 +1,58 @@
+#include "rendercache.h"
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start redrawing a layer if needed
+bool BeginCachedLayer(CachedLayer *layer, int width, int height, unsigned int key) {
+    if (layer->valid && layer->key == key && layer->width == width && layer->height == height) return false;
+
+    // Nothing to draw into (e.g. minimized window)
+    if (width <= 0 || height <= 0) {
+        layer->valid = false;
+        return false;
+    }
+
+    // A new size needs a new render target
+    if (layer->target.id == 0 || layer->width != width || layer->height != height) {
+        if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+        layer->target = LoadRenderTexture(width, height);
+        layer->width = width;
+        layer->height = height;
+    }
+
+    layer->key = key;
+    layer->valid = true;
+
+    BeginTextureMode(layer->target);
+    ClearBackground(BLANK);
+    return true;
+}
+
+// Finish redrawing a layer
+void EndCachedLayer(void) {
+    EndTextureMode();
+}
+
+// Blit the layer (render textures are stored upside down, hence the negative source height)
+void DrawCachedLayer(const CachedLayer *layer, Vector2 position, Color tint) {
+    if (!layer->valid) return;
+
+    Rectangle source = { 0, 0, (float)layer->width, -(float)layer->height };
+    DrawTextureRec(layer->target.texture, source, position, tint);
+}
+
+// Force a redraw
+void InvalidateCachedLayer(CachedLayer *layer) {
+    layer->valid = false;
+}
+
+// Free the render target
+void UnloadCachedLayer(CachedLayer *layer) {
+    if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+    layer->target = (RenderTexture2D){ 0 };
+    layer->width = 0;
+    layer->height = 0;
+    layer->valid = false;
+}
@@ -0,0 +1,34 @@
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include "raylib.h"
+
+// Render target caching: content that rarely changes (static screens, the paused frame, HUD
+// messages) is drawn once into a RenderTexture2D and then blitted every frame. A layer is
+// redrawn only when its size or its key (any value describing the content) changes.
+typedef struct {
+    RenderTexture2D target;
+    int width;
+    int height;
+    unsigned int key;       // Content the layer was rendered for (chosen by the caller)
+    bool valid;             // False until rendered, or after InvalidateCachedLayer
+} CachedLayer;
+
+// Start redrawing the layer if it isn't valid for this size and key: returns true and makes
+// the layer the render target (cleared to BLANK), draw the content and call EndCachedLayer.
+// Returns false if the cached content can be used as it is.
+bool BeginCachedLayer(CachedLayer *layer, int width, int height, unsigned int key);
+
+// Finish redrawing a layer (restores the screen as render target)
+void EndCachedLayer(void);
+
+// Blit the layer at a screen position, the tint multiplies it (e.g. to fade it)
+void DrawCachedLayer(const CachedLayer *layer, Vector2 position, Color tint);
+
+// Force a redraw on the next BeginCachedLayer
+void InvalidateCachedLayer(CachedLayer *layer);
+
+// Free the render target of a layer
+void UnloadCachedLayer(CachedLayer *layer);
+
+#endif // RENDERCACHE_H
@@ -0,0 +1,190 @@
+#include "replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initial capacity of the recording buffer (one minute at 60 fps)
+#define REPLAY_INITIAL_FRAMES   3600
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+
+// Recording: frames are kept in memory and written on stop so recording never waits on disk
+static unsigned char *recordData = NULL;
+static int recordFrames = 0;
+static int recordCapacity = 0;
+static unsigned int recordSeed = 0;
+static char recordFileName[256] = { 0 };
+static bool recording = false;
+
+// Playback
+static unsigned char *replayData = NULL;
+static int replayFrames = 0;
+static int replayPosition = 0;
+static unsigned int replaySeed = 0;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Encode one frame
+static void EncodeFrame(unsigned char *dst, GameInput input) {
+    dst[0] = (unsigned char)input.down;
+    dst[1] = (unsigned char)input.pressed;
+    memcpy(dst + 2, &input.deltaTime, sizeof(float));
+}
+
+// Decode one frame
+static GameInput DecodeFrame(const unsigned char *src) {
+    GameInput input = { 0 };
+    input.down = src[0];
+    input.pressed = src[1];
+    memcpy(&input.deltaTime, src + 2, sizeof(float));
+    return input;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start recording
+bool StartReplayRecording(const char *fileName, unsigned int seed) {
+    if (recording) StopReplayRecording();
+
+    recordData = malloc(REPLAY_INITIAL_FRAMES * REPLAY_FRAME_SIZE);
+    if (recordData == NULL) return false;
+
+    recordCapacity = REPLAY_INITIAL_FRAMES;
+    recordFrames = 0;
+    recordSeed = seed;
+    snprintf(recordFileName, sizeof(recordFileName), "%s", fileName);
+    recording = true;
+
+    return true;
+}
+
+// Add the input of one frame to the recording
+void RecordReplayFrame(GameInput input) {
+    if (!recording) return;
+
+    if (recordFrames == recordCapacity) {
+        unsigned char *data = realloc(recordData, (size_t)recordCapacity * 2 * REPLAY_FRAME_SIZE);
+        if (data == NULL) {
+            printf("Error: out of memory, replay recording stopped at frame %d\n", recordFrames);
+            StopReplayRecording();
+            return;
+        }
+        recordData = data;
+        recordCapacity *= 2;
+    }
+
+    EncodeFrame(recordData + (size_t)recordFrames * REPLAY_FRAME_SIZE, input);
+    recordFrames++;
+}
+
+// Write the recording and stop
+void StopReplayRecording(void) {
+    if (!recording) return;
+
+    FILE *file = fopen(recordFileName, "wb");
+    if (file != NULL) {
+        ReplayHeader header = { 0 };
+        memcpy(header.magic, REPLAY_MAGIC, 4);
+        header.version = REPLAY_VERSION;
+        header.seed = recordSeed;
+        header.frameCount = (uint32_t)recordFrames;
+
+        bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                       fwrite(recordData, REPLAY_FRAME_SIZE, recordFrames, file) == (size_t)recordFrames;
+        if (fclose(file) != 0) written = false;
+
+        if (written) printf("Replay saved: %s (%d frames, seed %u)\n", recordFileName, recordFrames, recordSeed);
+        else printf("Error writing replay: %s\n", recordFileName);
+    } else {
+        printf("Error creating replay: %s\n", recordFileName);
+    }
+
+    free(recordData);
+    recordData = NULL;
+    recordFrames = 0;
+    recordCapacity = 0;
+    recording = false;
+}
+
+// Check if a session is being recorded
+bool IsReplayRecording(void) {
+    return recording;
+}
+
+// Load a replay file in memory
+bool OpenReplay(const char *fileName) {
+    CloseReplay();
+
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) {
+        printf("Error opening replay: %s\n", fileName);
+        return false;
+    }
+
+    ReplayHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, REPLAY_MAGIC, 4) != 0 || header.version != REPLAY_VERSION) {
+        printf("Invalid replay file: %s\n", fileName);
+        fclose(file);
+        return false;
+    }
+
+    replayData = malloc((size_t)header.frameCount * REPLAY_FRAME_SIZE + 1);
+    if (replayData == NULL ||
+        fread(replayData, REPLAY_FRAME_SIZE, header.frameCount, file) != header.frameCount) {
+        printf("Truncated replay file: %s\n", fileName);
+        fclose(file);
+        CloseReplay();
+        return false;
+    }
+    fclose(file);
+
+    replayFrames = (int)header.frameCount;
+    replayPosition = 0;
+    replaySeed = header.seed;
+
+    return true;
+}
+
+// Seed stored in the open replay
+unsigned int GetReplaySeed(void) {
+    return replaySeed;
+}
+
+// Get the input of the next frame
+bool ReadReplayFrame(GameInput *input) {
+    if (replayPosition >= replayFrames) {
+        *input = (GameInput){ 0 };
+        return false;
+    }
+
+    *input = DecodeFrame(replayData + (size_t)replayPosition * REPLAY_FRAME_SIZE);
+    replayPosition++;
+
+    return true;
+}
+
+// Check if every frame has been played
+bool IsReplayFinished(void) {
+    return replayPosition >= replayFrames;
+}
+
+// Number of frames stored in the open replay
+int GetReplayFrameCount(void) {
+    return replayFrames;
+}
+
+// Free the open replay
+void CloseReplay(void) {
+    free(replayData);
+    replayData = NULL;
+    replayFrames = 0;
+    replayPosition = 0;
+    replaySeed = 0;
+}
@@ -0,0 +1,56 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "game.h"
+
+// Input replay file: the seed plus the input of every frame, enough to play a session again
+// step by step (same levels, same route, same enemy encounters)
+//
+// Layout: [ReplayHeader][frameCount * REPLAY_FRAME_SIZE bytes]
+// Every frame is stored as down actions (1 byte), pressed actions (1 byte) and the frame
+// delta time (float, 4 bytes), all in native byte order like the asset pack.
+#define REPLAY_MAGIC        "MRRP"
+#define REPLAY_VERSION      1
+#define REPLAY_FRAME_SIZE   6
+
+// Replay file header
+typedef struct {
+    char magic[4];          // REPLAY_MAGIC
+    uint32_t version;       // REPLAY_VERSION
+    uint32_t seed;          // Seed the session was played with (see SetGameSeed)
+    uint32_t frameCount;    // Number of recorded frames
+} ReplayHeader;
+
+// Start recording the input of a session played with the given seed
+bool StartReplayRecording(const char *fileName, unsigned int seed);
+
+// Add the input of one frame to the recording
+void RecordReplayFrame(GameInput input);
+
+// Write the recording to its file and stop recording
+void StopReplayRecording(void);
+
+// Check if a session is being recorded
+bool IsReplayRecording(void);
+
+// Load a replay file in memory (no disk access while it plays)
+bool OpenReplay(const char *fileName);
+
+// Seed stored in the open replay
+unsigned int GetReplaySeed(void);
+
+// Get the input of the next frame, returns false once every frame has been played
+bool ReadReplayFrame(GameInput *input);
+
+// Check if every frame of the open replay has been played
+bool IsReplayFinished(void);
+
+// Number of frames stored in the open replay
+int GetReplayFrameCount(void);
+
+// Free the open replay
+void CloseReplay(void);
+
+#endif // REPLAY_H
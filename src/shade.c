@@ -0,0 +1,54 @@
+#include "shade.h"
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Fill the shade tables
+void BuildShadeTable(ShadeTable *table, float fogStart, float fogEnd) {
+    table->fogEnd = fogEnd;
+    table->bucketScale = FOG_BUCKETS / fogEnd;
+
+    for (int side = 0; side < 2; side++) {
+        float sideShade = (side == 1) ? SIDE_SHADE / 255.0f : 1.0f;
+
+        for (int light = 0; light < LIGHT_LEVELS; light++) {
+            float brightness = sideShade * light / (LIGHT_LEVELS - 1);
+
+            for (int bucket = 0; bucket < FOG_BUCKETS; bucket++) {
+                // Fog at the middle of the bucket, linear from fogStart to fogEnd
+                float distance = (bucket + 0.5f) / table->bucketScale;
+                float fog = (fogEnd - distance) / (fogEnd - fogStart);
+                if (fog > 1.0f) fog = 1.0f;
+                if (fog < 0.0f) fog = 0.0f;
+
+                table->levels[side][light][bucket] = (unsigned char)(brightness * fog * (SHADE_LEVELS - 1) + 0.5f);
+            }
+        }
+    }
+
+    for (int level = 0; level < SHADE_LEVELS; level++) {
+        table->scales[level] = (unsigned short)((level * 256 + (SHADE_LEVELS - 1) / 2) / (SHADE_LEVELS - 1));
+        for (int value = 0; value < 256; value++) {
+            table->ramps[level][value] = (unsigned char)((value * table->scales[level]) >> 8);
+        }
+    }
+}
+
+// Shade level of a surface
+int GetShadeLevel(const ShadeTable *table, int side, int light, float distance) {
+    if (!(distance < table->fogEnd)) return 0;
+    if (light < 0) light = 0;
+    if (light >= LIGHT_LEVELS) light = LIGHT_LEVELS - 1;
+
+    int bucket = (distance > 0.0f) ? (int)(distance * table->bucketScale) : 0;
+    if (bucket >= FOG_BUCKETS) bucket = FOG_BUCKETS - 1;
+
+    return table->levels[side != 0][light][bucket];
+}
+
+// GPU tint of a shade level
+Color GetShadeTint(int level) {
+    unsigned char value = (unsigned char)((level * 255 + (SHADE_LEVELS - 1) / 2) / (SHADE_LEVELS - 1));
+    return (Color){ value, value, value, 255 };
+}
@@ -0,0 +1,38 @@
+#ifndef SHADE_H
+#define SHADE_H
+
+#include "raylib.h"
+#include "maze.h"
+
+// Distance fog and baked light, precomputed into lookup tables: the shade level of a surface
+// is read from (face side, light level, distance bucket) and the shaded value of a channel
+// from the ramp of that level, so drawing never does per-pixel float math. A ramp scales by
+// the 8.8 fixed-point factor of its level, ramps[level][v] = (v * scales[level]) >> 8, which
+// SIMD code can compute directly with the same result
+
+#define FOG_BUCKETS     64          // Distance buckets between the camera and the end of the fog
+#define SHADE_LEVELS    64          // Brightness levels (0 = black, SHADE_LEVELS-1 = unchanged)
+#define FOG_START       4.0f        // Distance (cells) where the fog begins
+#define FOG_END         14.0f       // Distance where everything is black
+#define SIDE_SHADE      180         // Brightness of north/south faces (of 255)
+
+typedef struct {
+    float fogEnd;
+    float bucketScale;                                      // Buckets per cell of distance
+    unsigned char levels[2][LIGHT_LEVELS][FOG_BUCKETS];     // Shade level by face side (0 = east/west
+                                                            // faces, floors and sprites, 1 = north/south
+                                                            // faces), light and distance bucket
+    unsigned short scales[SHADE_LEVELS];                    // Factor of each shade level (256 = unchanged)
+    unsigned char ramps[SHADE_LEVELS][256];                 // Channel value at each shade level
+} ShadeTable;
+
+// Fill the tables for a fog going from fogStart to fogEnd (fogEnd > fogStart)
+void BuildShadeTable(ShadeTable *table, float fogStart, float fogEnd);
+
+// Shade level of a surface at a distance (0 at fogEnd and beyond)
+int GetShadeLevel(const ShadeTable *table, int side, int light, float distance);
+
+// Tint that shades a texture drawn on the GPU like a shade level
+Color GetShadeTint(int level);
+
+#endif // SHADE_H
@@ -0,0 +1,679 @@
+#include "softrender.h"
+#include "workers.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#define SOFT_MAX_SPRITES    MAX_SORTED_POINTS   // Sprites drawn per call
+#define FLOOR_BANDS         32      // Parts the floor rows are split in for the workers
+#define FLOOR_COORD_OFFSET  4096.0f // Added to the floor coordinates (cells) so they stay positive
+
+// Ceiling and floor colors, as in the game renderer
+#define CEILING_COLOR   (Color){ 25, 25, 25, 255 }
+#define FLOOR_COLOR     (Color){ 50, 50, 50, 255 }
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Texture rows sampled down a stretched column: destination row r samples texture row
+// ((2r + 1) * textureHeight) / (2 * destHeight) (nearest, at the pixel center like the GPU),
+// found by stepping the quotient and remainder instead of dividing for every pixel
+typedef struct {
+    int row;                // Texture row of the current destination row
+    int remainder;
+    int step;               // Whole rows per destination row
+    int stepRemainder;
+    int divisor;            // 2 * destHeight
+} RowSampler;
+
+// Sampler positioned at a destination row
+static inline RowSampler StartRowSampler(int destRow, int destHeight, int textureHeight) {
+    RowSampler sampler;
+    sampler.divisor = 2 * destHeight;
+    sampler.row = ((2 * destRow + 1) * textureHeight) / sampler.divisor;
+    sampler.remainder = ((2 * destRow + 1) * textureHeight) % sampler.divisor;
+    sampler.step = (2 * textureHeight) / sampler.divisor;
+    sampler.stepRemainder = (2 * textureHeight) % sampler.divisor;
+    return sampler;
+}
+
+// First destination row that samples texture row textureRow or a later one (destHeight if none)
+static inline int FirstRowSampling(int textureRow, int destHeight, int textureHeight) {
+    long long numerator = 2LL * destHeight * textureRow - textureHeight;
+    if (numerator <= 0) return 0;
+
+    long long row = (numerator + 2LL * textureHeight - 1) / (2LL * textureHeight);
+    return (row < destHeight) ? (int)row : destHeight;
+}
+
+// Move a sampler to the next destination row
+static inline void AdvanceRowSampler(RowSampler *sampler) {
+    sampler->row += sampler->step;
+    sampler->remainder += sampler->stepRemainder;
+    if (sampler->remainder >= sampler->divisor) {
+        sampler->remainder -= sampler->divisor;
+        sampler->row++;
+    }
+}
+
+// Color through the ramp of a shade level (alpha untouched)
+static inline Color ShadeColor(Color color, const unsigned char *ramp) {
+    color.r = ramp[color.r];
+    color.g = ramp[color.g];
+    color.b = ramp[color.b];
+    return color;
+}
+
+#if defined(__SSE2__)
+// Four R8G8B8A8 pixels scaled by the 8.8 factor of a shade level, the same values as its ramp
+// (alpha is scaled by 256, unchanged)
+static inline __m128i ShadePixels4(__m128i pixels, __m128i scale) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), scale), 8);
+    __m128i high = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), scale), 8);
+    return _mm_packus_epi16(low, high);
+}
+#endif
+
+// Fill rows [startY, endY) with a color
+static void FillRows(SoftFrame *frame, int startY, int endY, Color color) {
+    for (int y = startY; y < endY; y++) {
+        Color *row = frame->pixels + (size_t)y * frame->width;
+        for (int x = 0; x < frame->width; x++) row[x] = color;
+    }
+}
+
+// Check if a texture can be sampled by DrawFloorRow, returns log2 of its size (0 if it can't)
+static int FloorTextureShift(const Image *texture) {
+    if (texture == NULL || texture->data == NULL || texture->width != texture->height) return 0;
+    if (texture->width < 2 || (texture->width & (texture->width - 1)) != 0) return 0;
+
+    int shift = 0;
+    while ((1 << shift) < texture->width) shift++;
+    return shift;
+}
+
+// Draw one row of floor or ceiling: pixel x samples texel (startU + x*stepU, startV + x*stepV),
+// wrapped to the power-of-two texture size. The coordinates only advance linearly along a row,
+// so four pixels are computed at once with SSE2 (the scalar loop computes the same values).
+// The mirrored row of the other surface, if any, reuses the texel indices (same texture size).
+// Both rows are at the same distance and share their shade level
+static void DrawFloorRow(Color *row, Color *mirrorRow, int width, float startU, float startV, float stepU, float stepV,
+                         const Image *texture, const Image *mirrorTexture, int shift, const ShadeTable *shades, int level) {
+    const unsigned int *texels = (const unsigned int *)texture->data;
+    const unsigned int *mirrorTexels = (mirrorRow != NULL) ? (const unsigned int *)mirrorTexture->data : NULL;
+    unsigned int *pixels = (unsigned int *)row;
+    unsigned int *mirrorPixels = (unsigned int *)mirrorRow;
+    int mask = texture->width - 1;
+    bool shaded = (level < SHADE_LEVELS - 1);
+    const unsigned char *ramp = shades->ramps[level];
+    int x = 0;
+
+#if defined(__SSE2__)
+    __m128 column = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);     // Exact column numbers (x < 2^24)
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 startU4 = _mm_set1_ps(startU);
+    const __m128 startV4 = _mm_set1_ps(startV);
+    const __m128 stepU4 = _mm_set1_ps(stepU);
+    const __m128 stepV4 = _mm_set1_ps(stepV);
+    const __m128i mask4 = _mm_set1_epi32(mask);
+    const __m128i shift4 = _mm_cvtsi32_si128(shift);
+    const int scale = shades->scales[level];
+    const __m128i scale4 = _mm_setr_epi16(scale, scale, scale, 256, scale, scale, scale, 256);
+
+    for (; x + 4 <= width; x += 4, column = _mm_add_ps(column, four)) {
+        __m128i u = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(startU4, _mm_mul_ps(stepU4, column))), mask4);
+        __m128i v = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(startV4, _mm_mul_ps(stepV4, column))), mask4);
+
+        _Alignas(16) int index[4];
+        _mm_store_si128((__m128i *)index, _mm_or_si128(_mm_sll_epi32(v, shift4), u));
+        __m128i texel4 = _mm_setr_epi32((int)texels[index[0]], (int)texels[index[1]], (int)texels[index[2]], (int)texels[index[3]]);
+        _mm_storeu_si128((__m128i *)(pixels + x), shaded ? ShadePixels4(texel4, scale4) : texel4);
+        if (mirrorPixels != NULL) {
+            texel4 = _mm_setr_epi32((int)mirrorTexels[index[0]], (int)mirrorTexels[index[1]],
+                                    (int)mirrorTexels[index[2]], (int)mirrorTexels[index[3]]);
+            _mm_storeu_si128((__m128i *)(mirrorPixels + x), shaded ? ShadePixels4(texel4, scale4) : texel4);
+        }
+    }
+#endif
+
+    for (; x < width; x++) {
+        int u = (int)(startU + stepU * (float)x) & mask;
+        int v = (int)(startV + stepV * (float)x) & mask;
+        int index = (v << shift) | u;
+        pixels[x] = texels[index];
+        if (mirrorPixels != NULL) mirrorPixels[x] = mirrorTexels[index];
+        if (shaded) {
+            row[x] = ShadeColor(row[x], ramp);
+            if (mirrorRow != NULL) mirrorRow[x] = ShadeColor(mirrorRow[x], ramp);
+        }
+    }
+}
+
+// Floor and ceiling of one frame, shared by the workers
+typedef struct {
+    SoftFrame *frame;
+    const Image *textures[2];       // Floor, ceiling
+    int shifts[2];                  // log2 of their sizes (0 = flat color)
+    Vector2 origin;                 // Camera position (plus FLOOR_COORD_OFFSET)
+    Vector2 rayLeft;                // Ray of the left screen edge
+    Vector2 rayStep;                // Ray change from one column to the next
+    int halfHeight;
+    const ShadeTable *shades;
+    int light;                      // Light level of the camera cell, used for the whole surface
+} FloorPass;
+
+// Draw one band of rows: floor row halfHeight + k and its mirrored ceiling row halfHeight - 1 - k
+static void DrawFloorBand(void *data, int part, int partCount) {
+    const FloorPass *pass = (const FloorPass *)data;
+    SoftFrame *frame = pass->frame;
+    int first = pass->halfHeight * part / partCount;
+    int last = pass->halfHeight * (part + 1) / partCount;
+
+    for (int k = first; k < last; k++) {
+        // Distance to the floor seen by this row (through its pixel centers), the eye is half
+        // a wall high as in ComputeWallColumn
+        float distance = (0.5f * frame->height) / (k + 0.5f);
+        float startX = pass->origin.x + distance * pass->rayLeft.x;
+        float startY = pass->origin.y + distance * pass->rayLeft.y;
+        float stepX = distance * pass->rayStep.x;
+        float stepY = distance * pass->rayStep.y;
+
+        Color *rows[2] = {
+            frame->pixels + (size_t)(pass->halfHeight + k) * frame->width,
+            frame->pixels + (size_t)(pass->halfHeight - 1 - k) * frame->width
+        };
+
+        // Rows past the end of the fog are black
+        int level = GetShadeLevel(pass->shades, 0, pass->light, distance);
+        if (level == 0) {
+            for (int x = 0; x < frame->width; x++) rows[0][x] = rows[1][x] = BLACK;
+            continue;
+        }
+        const unsigned char *ramp = pass->shades->ramps[level];
+        const Color flat[2] = { ShadeColor(FLOOR_COLOR, ramp), ShadeColor(CEILING_COLOR, ramp) };
+
+        // Floor and ceiling textures of the same size share the texel indices
+        bool shared = (pass->shifts[0] != 0) && (pass->shifts[0] == pass->shifts[1]);
+
+        for (int surface = 0; surface < (shared ? 1 : 2); surface++) {
+            int shift = pass->shifts[surface];
+
+            if (shift == 0) {
+                for (int x = 0; x < frame->width; x++) rows[surface][x] = flat[surface];
+            } else {
+                float size = (float)(1 << shift);
+                DrawFloorRow(rows[surface], shared ? rows[1] : NULL, frame->width, startX * size, startY * size,
+                             stepX * size, stepY * size, pass->textures[surface], pass->textures[1], shift, pass->shades, level);
+            }
+        }
+    }
+}
+
+// Draw one texture column (contiguous texels) stretched over rows [startY, endY) of screen
+// column x, shaded by the ramp of its shade level
+static void DrawTextureColumn(SoftFrame *frame, int x, int startY, int endY, const Color *column, int columnHeight,
+                              const unsigned char *ramp) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    Color *pixel = frame->pixels + (size_t)startY * frame->width + x;
+    RowSampler sampler = StartRowSampler(0, height, columnHeight);
+    for (int row = 0; row < height; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+        Color texel = ShadeColor(column[sampler.row], ramp);
+        texel.a = 255;
+        *pixel = texel;
+    }
+}
+
+// Draw one column of palette indices stretched over rows [startY, endY) of screen column x,
+// the colormap of its shade level gives the colors
+static void DrawIndexedColumn(SoftFrame *frame, int x, int startY, int endY, const unsigned char *column,
+                              int columnHeight, const Color *colormap) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    Color *pixel = frame->pixels + (size_t)startY * frame->width + x;
+    RowSampler sampler = StartRowSampler(0, height, columnHeight);
+    for (int row = 0; row < height; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+        Color texel = colormap[column[sampler.row]];
+        texel.a = 255;
+        *pixel = texel;
+    }
+}
+
+// Blend a partially transparent texel over a pixel (straight alpha)
+static inline void BlendTranslucent(Color *pixel, Color texel) {
+    int alpha = texel.a;
+    pixel->r = (unsigned char)((texel.r * alpha + pixel->r * (255 - alpha) + 127) / 255);
+    pixel->g = (unsigned char)((texel.g * alpha + pixel->g * (255 - alpha) + 127) / 255);
+    pixel->b = (unsigned char)((texel.b * alpha + pixel->b * (255 - alpha) + 127) / 255);
+    pixel->a = 255;
+}
+
+// Blend a texel over a pixel (straight alpha)
+static inline void BlendPixel(Color *pixel, Color texel) {
+    if (texel.a == 255) *pixel = texel;
+    else BlendTranslucent(pixel, texel);
+}
+
+// Blend one texture column (contiguous texels) over rows [startY, endY) of screen column x,
+// shaded by the ramp of its shade level
+static void BlendTextureColumn(SoftFrame *frame, int x, int startY, int endY, const Color *column, int columnHeight,
+                               const unsigned char *ramp) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    Color *pixel = frame->pixels + (size_t)startY * frame->width + x;
+    RowSampler sampler = StartRowSampler(0, height, columnHeight);
+    for (int row = 0; row < height; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+        Color texel = column[sampler.row];
+        if (texel.a == 0) continue;
+
+        BlendPixel(pixel, ShadeColor(texel, ramp));
+    }
+}
+
+// Blend one column of palette indices over rows [startY, endY) of screen column x, the
+// colormap of its shade level gives the colors
+static void BlendIndexedColumn(SoftFrame *frame, int x, int startY, int endY, const unsigned char *column,
+                               int columnHeight, const Color *colormap) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    Color *pixel = frame->pixels + (size_t)startY * frame->width + x;
+    RowSampler sampler = StartRowSampler(0, height, columnHeight);
+    for (int row = 0; row < height; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+        int index = column[sampler.row];
+        if (index == PALETTE_TRANSPARENT) continue;
+
+        BlendPixel(pixel, colormap[index]);
+    }
+}
+
+// Draw the posts of column texX of a texture stretched over rows [startY, endY) of screen
+// column x: only the rows sampling a post are visited, opaque posts are copied and
+// translucent ones blended, with no alpha test per pixel
+static void DrawColumnPosts(SoftFrame *frame, int x, int startY, int endY, const SoftTexture *texture, int texX,
+                            const unsigned char *ramp) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    const Color *column = texture->mips[0] + (size_t)texX * texture->height;
+    for (int p = texture->columnPosts[texX]; p < texture->columnPosts[texX + 1]; p++) {
+        const SoftPost *post = &texture->posts[p];
+        int first = FirstRowSampling(post->top, height, texture->height);
+        int last = FirstRowSampling(post->top + post->length, height, texture->height);
+
+        Color *pixel = frame->pixels + (size_t)(startY + first) * frame->width + x;
+        RowSampler sampler = StartRowSampler(first, height, texture->height);
+        if (post->translucent) {
+            for (int row = first; row < last; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+                BlendTranslucent(pixel, ShadeColor(column[sampler.row], ramp));
+            }
+        } else {
+            for (int row = first; row < last; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+                *pixel = ShadeColor(column[sampler.row], ramp);
+            }
+        }
+    }
+}
+
+// Draw the posts of column texX of a palettized texture, as DrawColumnPosts (the colors of
+// the indices are already shaded by the colormap)
+static void DrawIndexedPosts(SoftFrame *frame, int x, int startY, int endY, const SoftTexture *texture, int texX,
+                             const Color *colormap) {
+    int height = endY - startY;
+    if (height <= 0) return;
+
+    const unsigned char *column = texture->indexed->indices + (size_t)texX * texture->height;
+    for (int p = texture->columnPosts[texX]; p < texture->columnPosts[texX + 1]; p++) {
+        const SoftPost *post = &texture->posts[p];
+        int first = FirstRowSampling(post->top, height, texture->height);
+        int last = FirstRowSampling(post->top + post->length, height, texture->height);
+
+        Color *pixel = frame->pixels + (size_t)(startY + first) * frame->width + x;
+        RowSampler sampler = StartRowSampler(first, height, texture->height);
+        if (post->translucent) {
+            for (int row = first; row < last; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+                BlendTranslucent(pixel, colormap[column[sampler.row]]);
+            }
+        } else {
+            for (int row = first; row < last; row++, pixel += frame->width, AdvanceRowSampler(&sampler)) {
+                *pixel = colormap[column[sampler.row]];
+            }
+        }
+    }
+}
+
+// Kind of texel a post can hold: 0 = transparent (no post), 1 = opaque, 2 = translucent.
+// Texel i of level 0, or of the indices (the colormaps keep the alpha of the palette)
+static inline int TexelClass(const SoftTexture *texture, size_t i) {
+    if (texture->indexed != NULL) {
+        int index = texture->indexed->indices[i];
+        if (index == PALETTE_TRANSPARENT) return 0;
+        return (texture->colormaps->colors[0][index].a == 255) ? 1 : 2;
+    }
+
+    int alpha = texture->mips[0][i].a;
+    return (alpha == 0) ? 0 : (alpha == 255) ? 1 : 2;
+}
+
+// Split every column of level 0 (or of the indices) in posts (counted first, then stored in one
+// block). Opaque textures get none, and a texture whose posts can't be allocated is drawn with
+// alpha tests
+static void BuildSoftPosts(SoftTexture *texture) {
+    size_t texelCount = (size_t)texture->width * texture->height;
+
+    bool transparent = false;
+    for (size_t i = 0; i < texelCount && !transparent; i++) transparent = (TexelClass(texture, i) != 1);
+    if (!transparent || texture->height > 65535) return;
+
+    int postCount = 0;
+    for (int x = 0; x < texture->width; x++) {
+        size_t column = (size_t)x * texture->height;
+        for (int y = 0; y < texture->height; y++) {
+            int kind = TexelClass(texture, column + y);
+            if ((kind != 0) && ((y == 0) || (TexelClass(texture, column + y - 1) != kind))) postCount++;
+        }
+    }
+
+    size_t offsetsSize = (size_t)(texture->width + 1) * sizeof(int);
+    void *memory = malloc(offsetsSize + (size_t)postCount * sizeof(SoftPost));
+    if (memory == NULL) return;
+
+    int *columnPosts = (int *)memory;
+    SoftPost *posts = (SoftPost *)((unsigned char *)memory + offsetsSize);
+    int count = 0;
+    for (int x = 0; x < texture->width; x++) {
+        size_t column = (size_t)x * texture->height;
+        columnPosts[x] = count;
+        for (int y = 0; y < texture->height;) {
+            int kind = TexelClass(texture, column + y);
+            int top = y;
+            while ((y < texture->height) && (TexelClass(texture, column + y) == kind)) y++;
+            if (kind != 0) posts[count++] = (SoftPost){ (unsigned short)top, (unsigned short)(y - top), kind == 2 };
+        }
+    }
+    columnPosts[texture->width] = count;
+
+    texture->posts = posts;
+    texture->columnPosts = columnPosts;
+    texture->postMemory = memory;
+}
+
+// Mip level of a texture for a column drawn height rows high: the smallest level that still
+// has as many rows as the column, so distant short columns read a few texels of a small level
+static int SelectMipLevel(const SoftTexture *texture, int height) {
+    int mip = 0;
+    while (mip + 1 < texture->mipCount && (texture->height >> (mip + 1)) >= height) mip++;
+    return mip;
+}
+
+// Draw (blend = false) or blend column texX (of level 0) of a texture over rows [startY, endY)
+// of screen column x, sampling a mip level, at a shade level
+static void DrawSoftTextureColumn(SoftFrame *frame, int x, int startY, int endY, const SoftTexture *texture, int texX,
+                                  int mip, const ShadeTable *shades, int level, bool blend) {
+    if (texture->indexed != NULL) {
+        const unsigned char *column = texture->indexed->indices + (size_t)texX * texture->height;
+        const Color *colormap = texture->colormaps->colors[level];
+
+        if (blend && texture->posts != NULL) DrawIndexedPosts(frame, x, startY, endY, texture, texX, colormap);
+        else if (blend) BlendIndexedColumn(frame, x, startY, endY, column, texture->height, colormap);
+        else DrawIndexedColumn(frame, x, startY, endY, column, texture->height, colormap);
+    } else if (blend && mip == 0 && texture->posts != NULL) {
+        DrawColumnPosts(frame, x, startY, endY, texture, texX, shades->ramps[level]);
+    } else {
+        int mipHeight = texture->height >> mip;
+        const Color *column = texture->mips[mip] + (size_t)(texX >> mip) * mipHeight;
+
+        if (blend) BlendTextureColumn(frame, x, startY, endY, column, mipHeight, shades->ramps[level]);
+        else DrawTextureColumn(frame, x, startY, endY, column, mipHeight, shades->ramps[level]);
+    }
+}
+
+// Average of four texels (rounded), one level of a mip chain
+static inline Color AverageTexels(Color a, Color b, Color c, Color d) {
+    return (Color){ (unsigned char)((a.r + b.r + c.r + d.r + 2) / 4), (unsigned char)((a.g + b.g + c.g + d.g + 2) / 4),
+                    (unsigned char)((a.b + b.b + c.b + d.b + 2) / 4), (unsigned char)((a.a + b.a + c.a + d.a + 2) / 4) };
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Allocate a framebuffer
+SoftFrame LoadSoftFrame(int width, int height) {
+    SoftFrame frame = { 0 };
+    frame.pixels = (Color *)calloc((size_t)width * height, sizeof(Color));
+    if (frame.pixels != NULL) {
+        frame.width = width;
+        frame.height = height;
+    }
+    return frame;
+}
+
+// Free a framebuffer
+void UnloadSoftFrame(SoftFrame *frame) {
+    free(frame->pixels);
+    frame->pixels = NULL;
+    frame->width = 0;
+    frame->height = 0;
+}
+
+// Prepare the texture of an R8G8B8A8 image
+SoftTexture LoadSoftTexture(const Image *image, bool mipmaps) {
+    SoftTexture texture = { 0 };
+    int width = image->width;
+    int height = image->height;
+
+    // Levels halve both sides while they stay whole
+    int mipCount = 1;
+    size_t texels = (size_t)width * height;
+    while (mipmaps && mipCount < SOFT_TEXTURE_MAX_MIPS && ((width >> (mipCount - 1)) % 2) == 0 &&
+           ((height >> (mipCount - 1)) % 2) == 0) {
+        texels += (size_t)(width >> mipCount) * (height >> mipCount);
+        mipCount++;
+    }
+
+    texture.memory = (Color *)malloc(texels * sizeof(Color));
+    if (texture.memory == NULL) return texture;
+
+    // Level 0 transposed, so every column is contiguous
+    const Color *source = (const Color *)image->data;
+    Color *level = texture.memory;
+    for (int x = 0; x < width; x++) {
+        for (int y = 0; y < height; y++) level[x * height + y] = source[y * width + x];
+    }
+    texture.mips[0] = level;
+
+    // Each smaller level averages 2x2 texels of the previous one (also column-major)
+    for (int mip = 1; mip < mipCount; mip++) {
+        const Color *previous = texture.mips[mip - 1];
+        int previousHeight = height >> (mip - 1);
+        int mipWidth = width >> mip;
+        int mipHeight = height >> mip;
+
+        level += (size_t)(width >> (mip - 1)) * previousHeight;
+        for (int x = 0; x < mipWidth; x++) {
+            const Color *left = previous + (size_t)(2 * x) * previousHeight;
+            const Color *right = left + previousHeight;
+            for (int y = 0; y < mipHeight; y++) {
+                level[x * mipHeight + y] = AverageTexels(left[2 * y], left[2 * y + 1], right[2 * y], right[2 * y + 1]);
+            }
+        }
+        texture.mips[mip] = level;
+    }
+
+    texture.width = width;
+    texture.height = height;
+    texture.mipCount = mipCount;
+    BuildSoftPosts(&texture);
+    return texture;
+}
+
+// Free the texels and posts of a texture
+void UnloadSoftTexture(SoftTexture *texture) {
+    free(texture->memory);
+    free(texture->postMemory);
+    *texture = (SoftTexture){ 0 };
+}
+
+// Bytes of a texture
+size_t GetSoftTextureMemory(const SoftTexture *texture) {
+    size_t bytes = 0;
+
+    if (texture->indexed != NULL) {
+        bytes += (size_t)texture->width * texture->height;
+    } else {
+        for (int mip = 0; mip < texture->mipCount; mip++) {
+            bytes += (size_t)(texture->width >> mip) * (texture->height >> mip) * sizeof(Color);
+        }
+    }
+
+    if (texture->posts != NULL) {
+        bytes += (size_t)(texture->width + 1) * sizeof(int) + (size_t)texture->columnPosts[texture->width] * sizeof(SoftPost);
+    }
+    return bytes;
+}
+
+// Texture of a palettized image
+SoftTexture MakeIndexedSoftTexture(const IndexedImage *image, const Colormaps *colormaps) {
+    SoftTexture texture = { 0 };
+    texture.width = image->width;
+    texture.height = image->height;
+    texture.mipCount = 1;
+    texture.indexed = image;
+    texture.colormaps = colormaps;
+    BuildSoftPosts(&texture);
+    return texture;
+}
+
+// Camera looking along an angle (computed in double precision and rounded: the float libm
+// functions may differ by an ulp from the compile-time folded values, which would change
+// the rendered pixels with the optimization flags)
+SoftCamera MakeSoftCamera(Vector2 position, float angle, float fov) {
+    float planeScale = (float)tan((double)fov * 0.5 * (3.14159265358979323846 / 180.0));
+    SoftCamera camera;
+    camera.position = position;
+    camera.dir = (Vector2){ (float)cos((double)angle), (float)sin((double)angle) };
+    camera.plane = (Vector2){ -camera.dir.y * planeScale, camera.dir.x * planeScale };
+    return camera;
+}
+
+// Draw the floor and ceiling
+void SoftRenderFloor(SoftFrame *frame, const Maze *maze, const SoftCamera *camera, const Image *floorTexture,
+                     const Image *ceilingTexture, const ShadeTable *shades) {
+    FloorPass pass;
+    pass.frame = frame;
+    pass.textures[0] = floorTexture;
+    pass.textures[1] = ceilingTexture;
+    pass.shifts[0] = FloorTextureShift(floorTexture);
+    pass.shifts[1] = FloorTextureShift(ceilingTexture);
+    pass.origin = (Vector2){ camera->position.x + FLOOR_COORD_OFFSET, camera->position.y + FLOOR_COORD_OFFSET };
+    pass.rayLeft = (Vector2){ camera->dir.x - camera->plane.x, camera->dir.y - camera->plane.y };
+    pass.rayStep = (Vector2){ 2.0f * camera->plane.x / frame->width, 2.0f * camera->plane.y / frame->width };
+    pass.halfHeight = frame->height / 2;
+    pass.shades = shades;
+    pass.light = LIGHT_AMBIENT;
+
+    int cellX = (int)camera->position.x;
+    int cellY = (int)camera->position.y;
+    if (IsPosInBounds(cellX, cellY)) pass.light = maze->light[cellY][cellX];
+
+    RunParallel(DrawFloorBand, &pass, (pass.halfHeight < FLOOR_BANDS) ? pass.halfHeight : FLOOR_BANDS);
+
+    // An odd last row stays black, as with the game's rectangles
+    if (2 * pass.halfHeight < frame->height) FillRows(frame, 2 * pass.halfHeight, frame->height, BLACK);
+}
+
+// Draw the walls
+bool SoftRenderWalls(SoftFrame *frame, ColumnBuffer *columns, const Maze *maze, const SoftCamera *camera,
+                     const SoftTexture *wallTexture, float maxDistance, CastMode mode, const ShadeTable *shades) {
+    if (!ReserveColumnBuffer(columns, frame->width)) return false;
+
+    RayCamera rayCamera = { camera->position, camera->dir, camera->plane,
+                            1.0f / (camera->plane.x * camera->dir.y - camera->dir.x * camera->plane.y) };
+    TraceColumns(columns, maze, &rayCamera, (float)frame->height, wallTexture->width, maxDistance, mode);
+
+    for (int x = 0; x < frame->width; x++) {
+        int light = maze->light[columns->cellY[x]][columns->cellX[x]];
+        int level = GetShadeLevel(shades, columns->side[x], light, columns->depth[x]);
+        int mip = SelectMipLevel(wallTexture, columns->drawEnd[x] - columns->drawStart[x]);
+        DrawSoftTextureColumn(frame, x, columns->drawStart[x], columns->drawEnd[x], wallTexture, columns->texX[x],
+                              mip, shades, level, false);
+    }
+
+    return true;
+}
+
+// Draw sprites from farthest to closest
+void SoftRenderSprites(SoftFrame *frame, const float *zBuffer, const SoftSprite *sprites, int count,
+                       int *order, const SoftCamera *camera, const ShadeTable *shades) {
+    Vector2 positions[SOFT_MAX_SPRITES];
+    if (count <= 0) return;
+    if (count > SOFT_MAX_SPRITES) count = SOFT_MAX_SPRITES;
+
+    for (int i = 0; i < count; i++) positions[i] = sprites[i].position;
+    SortByDistance(positions, count, camera->position, order);
+
+    for (int n = 0; n < count; n++) {
+        const SoftSprite *sprite = &sprites[order[n]];
+        Vector2 transform = TransformToCamera(sprite->position, camera->position, camera->dir, camera->plane);
+
+        SpriteProjection projection;
+        if (!ProjectSprite(transform, sprite->type, frame->width, frame->height, &projection)) continue;
+
+        int level = GetShadeLevel(shades, 0, sprite->light, projection.depth);
+        if (level == 0) continue;
+
+        int textureWidth = sprite->texture.width;
+        for (int stripe = projection.drawStartX; stripe < projection.drawEndX; stripe++) {
+            // Only draw if it's closer than a wall
+            if (projection.depth >= zBuffer[stripe]) continue;
+
+            int texX = (stripe - projection.drawStartX) * textureWidth / (projection.drawEndX - projection.drawStartX);
+            if (texX < 0) texX = 0;
+            if (texX >= textureWidth) texX = textureWidth - 1;
+
+            DrawSoftTextureColumn(frame, stripe, projection.drawStartY, projection.drawEndY, &sprite->texture, texX,
+                                  0, shades, level, true);
+        }
+    }
+}
+
+// Hash the pixels
+unsigned long long HashSoftFrame(const SoftFrame *frame) {
+    const unsigned char *bytes = (const unsigned char *)frame->pixels;
+    size_t size = (size_t)frame->width * frame->height * sizeof(Color);
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Write the frame as PPM
+bool ExportSoftFramePPM(const SoftFrame *frame, const char *fileName) {
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", frame->width, frame->height);
+
+    bool ok = true;
+    for (int i = 0; i < frame->width * frame->height && ok; i++) {
+        unsigned char rgb[3] = { frame->pixels[i].r, frame->pixels[i].g, frame->pixels[i].b };
+        ok = (fwrite(rgb, 1, 3, file) == 3);
+    }
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
@@ -0,0 +1,115 @@
+#ifndef SOFTRENDER_H
+#define SOFTRENDER_H
+
+#include "raylib.h"
+#include "maze.h"
+#include "raycast.h"
+#include "shade.h"
+#include "palette.h"
+#include <stddef.h>
+
+// Software (CPU) version of the raycaster and sprite renderer. It shares the ray casting and
+// the column/sprite geometry with the game renderer (raycast.h) and writes pixels into a
+// memory framebuffer, so frames can be rendered, hashed and compared without window or GPU.
+// Textures are Images with R8G8B8A8 pixels. Every surface is shaded by fog and the baked light
+// of the maze through a shade table (shade.h).
+
+// CPU framebuffer (row-major RGBA pixels)
+typedef struct {
+    Color *pixels;
+    int width;
+    int height;
+} SoftFrame;
+
+// Camera for one frame
+typedef struct {
+    Vector2 position;
+    Vector2 dir;
+    Vector2 plane;
+} SoftCamera;
+
+#define SOFT_TEXTURE_MAX_MIPS   8   // Mip levels of a texture at most (level 0 included)
+
+// Run of visible texels down one column of a texture (a post): all opaque or all partially
+// transparent, its texels are read in place from level 0 or the palette indices
+typedef struct {
+    unsigned short top;     // First texture row
+    unsigned short length;  // Texture rows
+    bool translucent;       // Texels have to be blended
+} SoftPost;
+
+// Wall or sprite texture: R8G8B8A8 texels stored column-major (a wall column is one
+// contiguous run) with a mip chain the walls pick from by projected height, or palette indices
+// shaded through colormaps (palette.h), a quarter of the texels plus the colormaps every indexed
+// texture shares. Textures with transparent texels also keep the posts of every column, so
+// sprites only visit what they show
+typedef struct {
+    int width;
+    int height;
+    int mipCount;                               // Levels in mips (1 = level 0 only)
+    const Color *mips[SOFT_TEXTURE_MAX_MIPS];   // Texels of each level, column-major (RGBA only)
+    Color *memory;                              // Block holding every level (owned)
+    const SoftPost *posts;                      // Posts of every column, top to bottom (NULL if opaque)
+    const int *columnPosts;                     // Posts of column x are [columnPosts[x], columnPosts[x + 1])
+    void *postMemory;                           // Block holding posts and columnPosts (owned)
+    const IndexedImage *indexed;                // Palette indices (NULL if not indexed)
+    const Colormaps *colormaps;                 // Colors of the indices at every shade level (indexed only)
+} SoftTexture;
+
+// Sprite drawn by the software renderer
+typedef struct {
+    Vector2 position;
+    CellType type;          // Decides size and placement, as in the game (key, enemy, exit)
+    SoftTexture texture;
+    int light;              // Light level of the sprite's cell
+} SoftSprite;
+
+// Allocate a framebuffer (the pixels are cleared to black)
+SoftFrame LoadSoftFrame(int width, int height);
+
+// Free a framebuffer
+void UnloadSoftFrame(SoftFrame *frame);
+
+// Prepare the texture of an R8G8B8A8 image: transpose it and, if asked, build its mip chain
+// (2x2 box filter, down to the first odd side) and, if it has transparent texels, its posts.
+// memory is NULL if it can't be allocated
+SoftTexture LoadSoftTexture(const Image *image, bool mipmaps);
+
+// Free the texels and posts of a texture made by LoadSoftTexture or MakeIndexedSoftTexture
+void UnloadSoftTexture(SoftTexture *texture);
+
+// Bytes of a texture: every mip level or its indices, and its posts (the shared colormaps of
+// indexed textures aren't counted)
+size_t GetSoftTextureMemory(const SoftTexture *texture);
+
+// Texture of a palettized image, with its posts if it has transparent texels (no mips, the
+// indices stay owned by the caller)
+SoftTexture MakeIndexedSoftTexture(const IndexedImage *image, const Colormaps *colormaps);
+
+// Camera at a position looking along an angle (radians) with the given field of view (degrees)
+SoftCamera MakeSoftCamera(Vector2 position, float angle, float fov);
+
+// Draw the floor and ceiling by horizontal scanline casting, the rows are split over the
+// threads of workers.h. Textures must be square with a power-of-two size, a surface without
+// one (NULL or another size) gets the flat color of the game. Each row is fogged by its
+// distance and lit by the light of the camera cell
+void SoftRenderFloor(SoftFrame *frame, const Maze *maze, const SoftCamera *camera, const Image *floorTexture,
+                     const Image *ceilingTexture, const ShadeTable *shades);
+
+// Draw the textured walls over the floor and ceiling, tracing the columns into a column buffer
+// (its depths are the z-buffer of SoftRenderSprites), returns false if the buffer can't grow
+bool SoftRenderWalls(SoftFrame *frame, ColumnBuffer *columns, const Maze *maze, const SoftCamera *camera,
+                     const SoftTexture *wallTexture, float maxDistance, CastMode mode, const ShadeTable *shades);
+
+// Draw sprites from farthest to closest, clipped against the z-buffer. order keeps count
+// sprite indices between frames (initialize it to 0..count-1)
+void SoftRenderSprites(SoftFrame *frame, const float *zBuffer, const SoftSprite *sprites, int count,
+                       int *order, const SoftCamera *camera, const ShadeTable *shades);
+
+// 64-bit FNV-1a hash of the pixels
+unsigned long long HashSoftFrame(const SoftFrame *frame);
+
+// Write the frame as a binary PPM (P6) file
+bool ExportSoftFramePPM(const SoftFrame *frame, const char *fileName);
+
+#endif // SOFTRENDER_H
@@ -0,0 +1,201 @@
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// One begin or end event
+typedef struct {
+    uint64_t timestamp;                  // Nanoseconds since the trace started
+    char phase;                          // 'B' (begin) or 'E' (end)
+    char name[TRACE_NAME_SIZE];
+} TraceEvent;
+
+// Block of events of one thread
+typedef struct TraceChunk {
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+    int count;
+    struct TraceChunk *next;
+} TraceChunk;
+
+// Event buffer of one thread
+typedef struct TraceThread {
+    int id;                              // Thread id shown in the timeline
+    char name[32];
+    TraceChunk *first;
+    TraceChunk *last;
+    struct TraceThread *next;
+} TraceThread;
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static atomic_bool traceEnabled;
+static bool traceUsed = false;                   // A trace was already recorded in this run
+static char traceFileName[256] = { 0 };
+static uint64_t traceStart = 0;
+
+static pthread_mutex_t threadsMutex = PTHREAD_MUTEX_INITIALIZER;
+static TraceThread *threads = NULL;              // Every thread that recorded an event
+static int threadCount = 0;
+static _Thread_local TraceThread *localThread = NULL;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Monotonic clock in nanoseconds
+static uint64_t ReadClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Get (registering it on first use) the buffer of the calling thread
+static TraceThread *GetLocalThread(void) {
+    if (localThread != NULL) return localThread;
+
+    TraceThread *thread = calloc(1, sizeof(TraceThread));
+    if (thread == NULL) return NULL;
+
+    pthread_mutex_lock(&threadsMutex);
+    thread->id = ++threadCount;
+    snprintf(thread->name, sizeof(thread->name), "Thread %d", thread->id);
+    thread->next = threads;
+    threads = thread;
+    pthread_mutex_unlock(&threadsMutex);
+
+    localThread = thread;
+    return thread;
+}
+
+// Append an event to the buffer of the calling thread
+static void AddEvent(char phase, const char *name) {
+    TraceThread *thread = GetLocalThread();
+    if (thread == NULL) return;
+
+    if (thread->last == NULL || thread->last->count == TRACE_CHUNK_EVENTS) {
+        TraceChunk *chunk = malloc(sizeof(TraceChunk));
+        if (chunk == NULL) return;
+
+        chunk->count = 0;
+        chunk->next = NULL;
+        if (thread->last != NULL) thread->last->next = chunk;
+        else thread->first = chunk;
+        thread->last = chunk;
+    }
+
+    TraceEvent *event = &thread->last->events[thread->last->count++];
+    event->timestamp = ReadClock() - traceStart;
+    event->phase = phase;
+    snprintf(event->name, sizeof(event->name), "%s", name);
+}
+
+// Write a JSON string, escaping the characters that need it
+static void WriteJsonString(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', file);
+        if ((unsigned char)*c >= 0x20) fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start recording events
+bool StartTrace(const char *fileName) {
+    if (traceUsed) return false;
+
+    traceUsed = true;
+    snprintf(traceFileName, sizeof(traceFileName), "%s", fileName);
+    traceStart = ReadClock();
+    atomic_store(&traceEnabled, true);
+
+    TraceSetThreadName("Main thread");
+    return true;
+}
+
+// Write every recorded event
+void StopTrace(void) {
+    if (!atomic_load(&traceEnabled)) return;
+    atomic_store(&traceEnabled, false);
+
+    FILE *file = fopen(traceFileName, "w");
+    if (file == NULL) printf("Error creating trace file: %s\n", traceFileName);
+
+    pthread_mutex_lock(&threadsMutex);
+
+    if (file != NULL) {
+        bool first = true;
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        for (TraceThread *thread = threads; thread != NULL; thread = thread->next) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",\n", thread->id);
+            WriteJsonString(file, thread->name);
+            fprintf(file, "}}");
+            first = false;
+
+            for (TraceChunk *chunk = thread->first; chunk != NULL; chunk = chunk->next) {
+                for (int i = 0; i < chunk->count; i++) {
+                    const TraceEvent *event = &chunk->events[i];
+                    fprintf(file, ",\n{\"name\":");
+                    WriteJsonString(file, event->name);
+                    fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                            event->phase, event->timestamp / 1000.0, thread->id);
+                }
+            }
+        }
+
+        fprintf(file, "\n]}\n");
+        fclose(file);
+        printf("Trace saved: %s\n", traceFileName);
+    }
+
+    // Free every buffer
+    while (threads != NULL) {
+        TraceThread *thread = threads;
+        threads = thread->next;
+
+        while (thread->first != NULL) {
+            TraceChunk *chunk = thread->first;
+            thread->first = chunk->next;
+            free(chunk);
+        }
+        free(thread);
+    }
+    localThread = NULL;
+
+    pthread_mutex_unlock(&threadsMutex);
+}
+
+// Check if events are being recorded
+bool IsTraceEnabled(void) {
+    return atomic_load_explicit(&traceEnabled, memory_order_relaxed);
+}
+
+// Name the calling thread
+void TraceSetThreadName(const char *name) {
+    if (!IsTraceEnabled()) return;
+
+    TraceThread *thread = GetLocalThread();
+    if (thread != NULL) snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+// Begin an event
+void TraceBegin(const char *name) {
+    if (!IsTraceEnabled()) return;
+    AddEvent('B', name);
+}
+
+// End an event
+void TraceEnd(const char *name) {
+    if (!IsTraceEnabled()) return;
+    AddEvent('E', name);
+}
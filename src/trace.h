@@ -0,0 +1,35 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+
+// Timeline tracing in the Chrome trace-event format (open the file in Perfetto or chrome://tracing)
+//
+// Every thread appends its begin/end events to its own buffer, so recording never takes a lock
+// after the first event of a thread. When tracing is off each call is a single branch.
+#define TRACE_NAME_SIZE     48       // Maximum event name length (longer names are truncated)
+#define TRACE_CHUNK_EVENTS  1024     // Events per buffer chunk (buffers grow one chunk at a time)
+
+// Trace the statement or block that follows (don't leave it with break/return/goto)
+#define TRACE_SCOPE(name) \
+    for (int traceScope_ = (TraceBegin(name), 0); traceScope_ == 0; TraceEnd(name), traceScope_ = 1)
+
+// Start recording events (only one trace per run), the file is written by StopTrace
+bool StartTrace(const char *fileName);
+
+// Write every recorded event to the trace file, call once the traced threads have finished
+void StopTrace(void);
+
+// Check if events are being recorded
+bool IsTraceEnabled(void);
+
+// Name the calling thread in the timeline
+void TraceSetThreadName(const char *name);
+
+// Begin an event on the calling thread (the name is copied)
+void TraceBegin(const char *name);
+
+// End the last event begun on the calling thread
+void TraceEnd(const char *name);
+
+#endif // TRACE_H
@@ -0,0 +1,41 @@
+#include "triplebuffer.h"
+
+#define TRIPLE_BUFFER_INDEX     3u      // Slot bits of the middle index
+#define TRIPLE_BUFFER_FRESH     4u      // Set when the middle slot hasn't been taken by the reader
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Set up the slots
+void InitTripleBuffer(TripleBuffer *buffer) {
+    buffer->front = 0;
+    buffer->back = 2;
+    atomic_init(&buffer->middle, 1);
+}
+
+// Slot the writer fills next
+unsigned int GetTripleBufferBack(const TripleBuffer *buffer) {
+    return buffer->back;
+}
+
+// Publish the back slot: swap it with the middle one (release, so the reader sees the writes)
+void PublishTripleBuffer(TripleBuffer *buffer) {
+    unsigned int previous = atomic_exchange_explicit(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH,
+                                                     memory_order_acq_rel);
+    buffer->back = previous & TRIPLE_BUFFER_INDEX;
+}
+
+// Take the latest published slot: swap the front with the middle one if it's fresh
+bool AcquireTripleBuffer(TripleBuffer *buffer) {
+    if (!(atomic_load_explicit(&buffer->middle, memory_order_relaxed) & TRIPLE_BUFFER_FRESH)) return false;
+
+    unsigned int previous = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+    buffer->front = previous & TRIPLE_BUFFER_INDEX;
+    return true;
+}
+
+// Slot the reader is using
+unsigned int GetTripleBufferFront(const TripleBuffer *buffer) {
+    return buffer->front;
+}
@@ -0,0 +1,33 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Lock-free triple buffer: one writer and one reader share three slots. The writer fills its
+// back slot and publishes it, the reader takes the latest published slot. Neither side ever
+// waits, the writer never touches the slot being read, and slots published while the reader
+// was busy are simply skipped (only the latest one matters). Only indices live here, the
+// caller owns an array of three slots.
+typedef struct {
+    atomic_uint middle;     // Last published slot, flagged while the reader hasn't taken it
+    unsigned int back;      // Slot being written (writer only)
+    unsigned int front;     // Slot being read (reader only)
+} TripleBuffer;
+
+// Set up the slots: nothing published, the reader starts on slot 0
+void InitTripleBuffer(TripleBuffer *buffer);
+
+// Slot the writer fills next
+unsigned int GetTripleBufferBack(const TripleBuffer *buffer);
+
+// Publish the back slot (the writer gets another free slot)
+void PublishTripleBuffer(TripleBuffer *buffer);
+
+// Take the latest published slot, returns false if nothing new was published
+bool AcquireTripleBuffer(TripleBuffer *buffer);
+
+// Slot the reader is using
+unsigned int GetTripleBufferFront(const TripleBuffer *buffer);
+
+#endif // TRIPLEBUFFER_H
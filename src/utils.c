@@ -1,5 +1,7 @@
 #include "utils.h"
+#include "assets.h"
 #include <math.h>
+#include <stdlib.h>
 
 // Calculate distance between two points
 float Distance(float x1, float y1, float x2, float y2) {
@@ -8,13 +10,73 @@ float Distance(float x1, float y1, float x2, float y2) {
     return sqrtf(dx*dx + dy*dy);
 }
 
-// Normalizar un ángulo entre 0 y 2*PI
+// Normalizar un ángulo entre 0 y 2*PI (constant time, whatever the number of turns)
 float NormalizeAngle(float angle) {
-    while (angle < 0) angle += 2.0f * PI;
-    while (angle >= 2.0f * PI) angle -= 2.0f * PI;
+    angle -= 2.0f * PI * floorf(angle * (1.0f / (2.0f * PI)));
+    
+    // Rounding can land exactly on 2*PI (e.g. tiny negative angles)
+    if (angle >= 2.0f * PI || angle < 0.0f) angle = 0.0f;
     return angle;
 }
 
+// Sine of one turn, with an extra entry so interpolation never wraps
+static float sinTable[TRIG_TABLE_SIZE + 1];
+
+// Fill the sine table
+void InitFastMath(void) {
+    for (int i = 0; i <= TRIG_TABLE_SIZE; i++) {
+        sinTable[i] = (float)sin(i * (2.0 * 3.14159265358979323846 / TRIG_TABLE_SIZE));
+    }
+}
+
+// Interpolated table lookup, position in table entries (any sign, |position| < 2^31)
+static inline float SineTableLookup(float position) {
+    int index = (int)position;
+    if ((float)index > position) index--;   // Floor without a libm call
+    
+    float fraction = position - (float)index;
+    index &= TRIG_TABLE_SIZE - 1;           // Wrap to one turn (two's complement for negatives)
+    
+    return sinTable[index] + (sinTable[index + 1] - sinTable[index]) * fraction;
+}
+
+// Table-driven sine
+float FastSin(float angle) {
+    return SineTableLookup(angle * (TRIG_TABLE_SIZE / (2.0f * PI)));
+}
+
+// Table-driven cosine (a quarter turn ahead of the sine)
+float FastCos(float angle) {
+    return SineTableLookup(angle * (TRIG_TABLE_SIZE / (2.0f * PI)) + TRIG_TABLE_SIZE / 4);
+}
+
+// Table-driven sine and cosine of the same angle
+void FastSinCos(float angle, float *sine, float *cosine) {
+    float position = angle * (TRIG_TABLE_SIZE / (2.0f * PI));
+    *sine = SineTableLookup(position);
+    *cosine = SineTableLookup(position + TRIG_TABLE_SIZE / 4);
+}
+
+// Approximate atan2: arctangent of the octant ratio with the polynomial of Abramowitz and
+// Stegun 4.4.49, then mirrored to the right quadrant
+float FastAtan2(float y, float x) {
+    float absX = fabsf(x);
+    float absY = fabsf(y);
+    float maxXY = (absX > absY) ? absX : absY;
+    float minXY = (absX > absY) ? absY : absX;
+    
+    if (maxXY == 0.0f) return 0.0f;
+    
+    float z = minXY / maxXY;
+    float z2 = z * z;
+    float result = z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+    
+    if (absY > absX) result = (PI / 2.0f) - result;
+    if (x < 0.0f) result = PI - result;
+    if (y < 0.0f) result = -result;
+    return result;
+}
+
 // Convertir degrees to radians
 float DegToRad(float degrees) {
     return degrees * DEG2RAD;
@@ -24,10 +86,118 @@ float DegToRad(float degrees) {
 float RadToDeg(float radians) {
     return radians * RAD2DEG;
 }
+
+// Interpolate linearly between two points
+Vector2 LerpVector2(Vector2 start, Vector2 end, float amount) {
+    return (Vector2){
+        start.x + (end.x - start.x) * amount,
+        start.y + (end.y - start.y) * amount
+    };
+}
+
+// Get the color of one texel
 Color GetTexturePixelColor(Texture2D texture, int x, int y) {
-    Color* pixels = LoadImageColors(LoadImageFromTexture(texture));
-    Color color = pixels[y * texture.width + x];
-    UnloadImageColors(pixels);
+    Color color;
+    Vector2 point = { (float)x, (float)y };
+    GetTexturePixelColors(texture, &point, 1, &color);
     return color;
 }
 
+// Get the colors of several texels at once
+void GetTexturePixelColors(Texture2D texture, const Vector2 *points, int count, Color *colors) {
+    const Image *image = GetTextureImage(texture);
+    Image readback = { 0 };
+    
+    // Textures not owned by the asset cache have no CPU copy: read them back once for the batch
+    if (image == NULL) {
+        readback = LoadImageFromTexture(texture);
+        ImageFormat(&readback, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        image = &readback;
+    }
+    
+    const Color *pixels = (const Color *)image->data;
+    
+    for (int i = 0; i < count; i++) {
+        int x = (int)points[i].x;
+        int y = (int)points[i].y;
+        
+        if (pixels != NULL && x >= 0 && x < image->width && y >= 0 && y < image->height) {
+            colors[i] = pixels[y * image->width + x];
+        } else {
+            colors[i] = BLANK;
+        }
+    }
+    
+    if (readback.data != NULL) UnloadImage(readback);
+}
+
+// Seed a random generator
+void SeedRandomState(RandomState *rng, unsigned int seed) {
+    // Mix the seed so consecutive seeds give unrelated sequences, xorshift can't start at 0
+    seed ^= seed >> 16;
+    seed *= 0x7feb352dU;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68bU;
+    seed ^= seed >> 16;
+    rng->state = (seed != 0) ? seed : 0x9e3779b9U;
+}
+
+// Next random 32-bit value
+unsigned int RandomNext(RandomState *rng) {
+    unsigned int x = rng->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng->state = x;
+    return x;
+}
+
+// Random float between 0.0 and 1.0
+float RandomFloat(RandomState *rng) {
+    return (RandomNext(rng) >> 8) * (1.0f / 16777215.0f);
+}
+
+// Allocate the memory block of an arena
+bool InitArena(Arena *arena, size_t capacity) {
+    arena->base = malloc(capacity);
+    arena->capacity = (arena->base != NULL) ? capacity : 0;
+    arena->used = 0;
+    arena->peak = 0;
+    arena->failures = 0;
+    return arena->base != NULL;
+}
+
+// Allocate from an arena
+void *ArenaAlloc(Arena *arena, size_t size) {
+    size_t offset = (arena->used + 15) & ~(size_t)15;
+    
+    if (arena->base == NULL || offset + size > arena->capacity) {
+        arena->failures++;
+        return NULL;
+    }
+    
+    arena->used = offset + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return arena->base + offset;
+}
+
+// Release every allocation of an arena
+void ResetArena(Arena *arena) {
+    arena->used = 0;
+}
+
+// Free the memory block of an arena
+void FreeArena(Arena *arena) {
+    free(arena->base);
+    arena->base = NULL;
+    arena->capacity = 0;
+    arena->used = 0;
+}
+
+// Log the high-water mark of an arena
+void ReportArena(const Arena *arena, const char *name) {
+    if (arena->capacity == 0) return;
+    
+    TraceLog((arena->failures > 0) ? LOG_WARNING : LOG_INFO, "ARENA: [%s] Peak %zu of %zu bytes (%.1f%%), %u allocations failed",
+             name, arena->peak, arena->capacity, 100.0 * arena->peak / arena->capacity, arena->failures);
+}
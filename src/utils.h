@@ -3,6 +3,7 @@
 
 #include "raylib.h"
 #include <math.h>
+#include <stddef.h>
 
 // Constants
 #define PI              3.14159265358979323846f
@@ -15,6 +16,25 @@ float Distance(float x1, float y1, float x2, float y2);
 // Normalizar un ángulo entre 0 y 2*PI
 float NormalizeAngle(float angle);
 
+// Fast math for the per-frame and per-step hot paths (table-driven sin/cos, polynomial atan2)
+// Errors are absolute, measured against double precision libm (checked by tools/bench)
+#define TRIG_TABLE_SIZE         4096     // Sine table entries per turn (power of two)
+#define FAST_TRIG_MAX_ERROR     1.0e-6f  // FastSin/FastCos/FastSinCos for |angle| <= 2*PI (grows with the angle)
+#define FAST_ATAN2_MAX_ERROR    1.5e-5f  // FastAtan2, in radians
+
+// Fill the sine table (call once at startup, before any other thread uses the fast math)
+void InitFastMath(void);
+
+// Sine and cosine read from the table with linear interpolation (|angle| < 1e6)
+float FastSin(float angle);
+float FastCos(float angle);
+
+// Sine and cosine of the same angle with a single range reduction
+void FastSinCos(float angle, float *sine, float *cosine);
+
+// Approximate atan2 (result in [-PI, PI], 0 for the origin)
+float FastAtan2(float y, float x);
+
 float DegToRad(float degrees);
 
 float RadToDeg(float radians);
@@ -28,6 +48,54 @@ float Clamp(float value, float min, float max);
 // Interpolate linearly between two values
 float Lerp(float start, float end, float amount);
 
+// Interpolate linearly between two points
+Vector2 LerpVector2(Vector2 start, Vector2 end, float amount);
+
+// Get the color of one texel (read from the CPU copy kept by the asset cache)
 Color GetTexturePixelColor(Texture2D texture, int x, int y);
 
+// Get the colors of several texels at once, points are texel coordinates
+// (out of range points return BLANK)
+void GetTexturePixelColors(Texture2D texture, const Vector2 *points, int count, Color *colors);
+
+// Deterministic random generator (xorshift32), each thread or level owns its own state
+typedef struct {
+    unsigned int state;
+} RandomState;
+
+// Seed a random generator (any seed is valid, including 0)
+void SeedRandomState(RandomState *rng, unsigned int seed);
+
+// Next random 32-bit value
+unsigned int RandomNext(RandomState *rng);
+
+// Random float between 0.0 and 1.0
+float RandomFloat(RandomState *rng);
+
+// Linear (bump) allocator, everything allocated from it is released at once
+// (per-level data lives in the level arenas, per-frame temporaries in a scratch arena reset
+// at the start of every frame)
+typedef struct {
+    unsigned char *base;    // Memory block
+    size_t capacity;        // Block size in bytes
+    size_t used;            // Bytes allocated so far
+    size_t peak;            // Most bytes ever in use at once (high-water mark, kept across resets)
+    unsigned int failures;  // Allocations refused because the arena was full
+} Arena;
+
+// Allocate the memory block of an arena
+bool InitArena(Arena *arena, size_t capacity);
+
+// Allocate from an arena (16-byte aligned), returns NULL if the arena is full
+void *ArenaAlloc(Arena *arena, size_t size);
+
+// Release every allocation of an arena in one step (the block is kept)
+void ResetArena(Arena *arena);
+
+// Free the memory block of an arena
+void FreeArena(Arena *arena);
+
+// Log the high-water mark of an arena against its capacity, to tune its budget
+void ReportArena(const Arena *arena, const char *name);
+
 #endif // UTILS_H
\ No newline at end of file
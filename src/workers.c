@@ -0,0 +1,148 @@
+#include "workers.h"
+#include "trace.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static pthread_t workerThreads[MAX_WORKERS];
+static int workerCount = 0;
+
+static pthread_mutex_t workMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workReady = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t workDone = PTHREAD_COND_INITIALIZER;
+
+// Current job (written under the mutex)
+static WorkerJob currentJob = NULL;
+static void *currentData = NULL;
+static int currentParts = 0;
+static unsigned int jobSerial = 0;          // Incremented for every job
+static int partsLeft = 0;                   // Parts not finished yet
+static int busyWorkers = 0;                 // Workers that haven't finished the current job yet
+static bool stopRequested = false;
+
+// Next part to hand out, tagged with the serial of its job: (serial << 32) | part
+static _Atomic unsigned long long nextPart;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Run parts of job serial until there are none left, returns the number of parts run. A part
+// is only claimed while the counter still belongs to that job, so a thread holding an older
+// job never takes (or runs its function on) the parts of a newer one
+static int RunParts(WorkerJob job, void *data, int partCount, unsigned int serial) {
+    int done = 0;
+    unsigned long long claim = atomic_load(&nextPart);
+
+    while ((unsigned int)(claim >> 32) == serial && (int)(claim & 0xffffffffu) < partCount) {
+        if (!atomic_compare_exchange_weak(&nextPart, &claim, claim + 1)) continue;
+
+        job(data, (int)(claim & 0xffffffffu), partCount);
+        done++;
+        claim = atomic_load(&nextPart);
+    }
+
+    return done;
+}
+
+// Worker thread: wait for a job, help with its parts, repeat
+static void *WorkerThread(void *arg) {
+    TraceSetThreadName("Worker");
+
+    // Jobs started after the thread was created (arg holds the serial of that moment): every
+    // one of them counts this worker as busy until it has been through it
+    unsigned int seenSerial = (unsigned int)(uintptr_t)arg;
+    pthread_mutex_lock(&workMutex);
+
+    for (;;) {
+        while (!stopRequested && jobSerial == seenSerial) pthread_cond_wait(&workReady, &workMutex);
+        if (stopRequested) break;
+
+        // RunParallel waits for every worker before returning, so this is the job the worker
+        // was counted in, and it stays alive until the worker reports back
+        seenSerial = jobSerial;
+        WorkerJob job = currentJob;
+        void *data = currentData;
+        int partCount = currentParts;
+        pthread_mutex_unlock(&workMutex);
+
+        int done = RunParts(job, data, partCount, seenSerial);
+
+        pthread_mutex_lock(&workMutex);
+        partsLeft -= done;
+        busyWorkers--;
+        if (partsLeft == 0 && busyWorkers == 0) pthread_cond_signal(&workDone);
+    }
+
+    pthread_mutex_unlock(&workMutex);
+    return NULL;
+}
+
+// ----------------------------------------------------------------------------------
+// Implementation of Public Functions
+// ----------------------------------------------------------------------------------
+
+// Start the worker threads
+int StartWorkers(int count) {
+    if (count > MAX_WORKERS) count = MAX_WORKERS;
+
+    stopRequested = false;
+    while (workerCount < count) {
+        void *serial = (void *)(uintptr_t)jobSerial;
+        if (pthread_create(&workerThreads[workerCount], NULL, WorkerThread, serial) != 0) break;
+        workerCount++;
+    }
+
+    return workerCount;
+}
+
+// Run a job on every thread
+void RunParallel(WorkerJob job, void *data, int partCount) {
+    // Nothing to share
+    if (workerCount == 0 || partCount <= 1) {
+        for (int part = 0; part < partCount; part++) job(data, part, partCount);
+        return;
+    }
+
+    pthread_mutex_lock(&workMutex);
+    currentJob = job;
+    currentData = data;
+    currentParts = partCount;
+    partsLeft = partCount;
+    unsigned int serial = ++jobSerial;
+    atomic_store(&nextPart, (unsigned long long)serial << 32);
+
+    // Every worker is busy from the broadcast on, even one that only wakes up once the parts
+    // are gone, so none can still be reading this job after the call returns
+    busyWorkers = workerCount;
+    pthread_cond_broadcast(&workReady);
+    pthread_mutex_unlock(&workMutex);
+
+    int done = RunParts(job, data, partCount, serial);
+
+    pthread_mutex_lock(&workMutex);
+    partsLeft -= done;
+    while (partsLeft > 0 || busyWorkers > 0) pthread_cond_wait(&workDone, &workMutex);
+    pthread_mutex_unlock(&workMutex);
+}
+
+// Worker threads running
+int GetWorkerCount(void) {
+    return workerCount;
+}
+
+// Stop the worker threads
+void StopWorkers(void) {
+    if (workerCount == 0) return;
+
+    pthread_mutex_lock(&workMutex);
+    stopRequested = true;
+    pthread_cond_broadcast(&workReady);
+    pthread_mutex_unlock(&workMutex);
+
+    for (int i = 0; i < workerCount; i++) pthread_join(workerThreads[i], NULL);
+    workerCount = 0;
+}
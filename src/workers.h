@@ -0,0 +1,26 @@
+#ifndef WORKERS_H
+#define WORKERS_H
+
+#include <stdbool.h>
+
+#define MAX_WORKERS     8        // Worker threads at most (the calling thread works too)
+
+// Job split in parts: called once for every part in [0, partCount), from any thread
+typedef void (*WorkerJob)(void *data, int part, int partCount);
+
+// Start count worker threads (0 runs every job on the calling thread), returns the number
+// of threads started
+int StartWorkers(int count);
+
+// Run every part of a job on the workers and the calling thread, returns once all of them are
+// done. The parts are handed out one at a time, so uneven parts still balance. Only one
+// thread may run jobs at a time
+void RunParallel(WorkerJob job, void *data, int partCount);
+
+// Worker threads running
+int GetWorkerCount(void);
+
+// Stop and join the worker threads
+void StopWorkers(void);
+
+#endif // WORKERS_H
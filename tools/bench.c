@@ -0,0 +1,621 @@
+/*******************************************************************************************
+*
+*   bench - Micro-benchmarks of the MazeRay engine hot kernels (no window needed)
+*
+*   Usage: bench [--reps N] [--warmup N] [--filter text]
+*
+*   Every kernel runs a fixed workload (fixed seeds and camera path): a few warm-up runs,
+*   then N timed repetitions. The output is CSV, one row per kernel, with the median and
+*   the median absolute deviation (MAD) of the time per operation in nanoseconds, so runs
+*   of different builds can be compared directly.
+*
+*   Before timing, the fast math of utils.h is checked against libm: the run fails (exit
+*   code 1) if the documented error bounds are exceeded.
+*
+*******************************************************************************************/
+
+#include "raylib.h"
+#include "../src/game.h"
+#include "../src/maze.h"
+#include "../src/raycast.h"
+#include "../src/softrender.h"
+#include "../src/utils.h"
+#include "../src/workers.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_SEED          20240601u
+#define DEFAULT_REPS        21
+#define DEFAULT_WARMUP      3
+#define MAX_REPS            1001
+
+#define SCREEN_COLUMNS      1280     // Rays per frame, as in the game window
+#define SCREEN_ROWS         720
+#define CAMERA_POSES        64       // Frames of the fixed camera path
+#define BENCH_SPRITES       64       // Sprites sorted and transformed per frame
+#define COLLISION_POINTS    4096     // Positions tested per collision run
+#define ENEMY_STEPS         600      // Simulation steps per enemy update run (10 seconds)
+#define MAX_BENCH_MAZE      127      // Largest generated maze
+#define MATH_SAMPLES        4096     // Angles/points per fast math run
+#define MATH_CHECK_SAMPLES  2000000  // Inputs of the fast math error check
+#define FLOOR_WIDTH         1920     // Frame of the floor casting kernel (1080p)
+#define FLOOR_HEIGHT        1080
+#define FLOOR_FRAMES        8        // Camera poses per floor casting run
+#define STILL_FRAMES        4        // Frames the camera stays at each pose of the still traversal kernel
+#define FLOOR_TEXTURE_SIZE  64
+#define WALL_TEXTURE_SIZE   256      // Wall texture of the wall distance kernels (256 KB of RGBA)
+#define WALL_FRAMES         8        // Frames per wall drawing run
+#define SPRITE_TEXTURE_SIZE 64       // Ring sprite of the sprite drawing kernels (mostly transparent)
+#define SPRITE_FRAMES       8        // Frames per sprite drawing run
+
+// Fixed camera pose
+typedef struct {
+    Vector2 position;
+    Vector2 dir;
+    Vector2 plane;
+} CameraPose;
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static CameraPose cameraPath[CAMERA_POSES];
+static ColumnBuffer columns;                 // Traversal pass output, reused like in the game
+static CastMode castMode = CAST_DDA;         // Mode used by the traversal kernel
+static Vector2 spritePoints[BENCH_SPRITES];
+static int spriteOrder[BENCH_SPRITES];
+static Vector2 collisionPoints[COLLISION_POINTS];
+static float mathAngles[MATH_SAMPLES];
+static Vector2 mathPoints[MATH_SAMPLES];
+static SoftFrame floorFrame;
+static Color floorTexels[FLOOR_TEXTURE_SIZE * FLOOR_TEXTURE_SIZE];
+static Image floorImage = { floorTexels, FLOOR_TEXTURE_SIZE, FLOOR_TEXTURE_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+static ShadeTable shades;
+static Color wallTexels[WALL_TEXTURE_SIZE * WALL_TEXTURE_SIZE];
+static Image wallImage = { wallTexels, WALL_TEXTURE_SIZE, WALL_TEXTURE_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+static SoftTexture wallTextures[3];          // Column-major with mips, without mips, palettized
+static const SoftTexture *wallTexture;       // Texture used by the wall kernel
+static IndexedImage wallIndexed;
+static Palette wallPalette;
+static Colormaps wallColormaps;
+static Maze wallRoom;                        // Empty lit room, the camera faces its south wall
+static ColumnBuffer wallColumns;
+static int wallDistance = 1;                 // Cells between the camera and the wall
+static Color spriteTexels[SPRITE_TEXTURE_SIZE * SPRITE_TEXTURE_SIZE];
+static Image spriteImage = { spriteTexels, SPRITE_TEXTURE_SIZE, SPRITE_TEXTURE_SIZE, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+static SoftTexture spriteTextures[4];        // RGBA and palettized, each with posts and with alpha tests
+static IndexedImage spriteIndexed;
+static Palette spritePalette;
+static Colormaps spriteColormaps;
+static SoftSprite benchSprite;               // Sprite of the sprite drawing kernel
+static float spriteDepths[FLOOR_WIDTH];      // Z-buffer with no wall in front of the sprite
+static unsigned char mazeCells[MAX_BENCH_MAZE * MAX_BENCH_MAZE];
+static int mazeSize = 15;                    // Size used by the maze generation kernel
+static unsigned int mazeSeed = 0;
+static volatile float sink;                  // Keeps results alive so nothing is optimized away
+
+static int repetitions = DEFAULT_REPS;
+static int warmupRuns = DEFAULT_WARMUP;
+static const char *filter = NULL;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Monotonic clock in nanoseconds
+static double ReadClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Sort helper for medians
+static int CompareDoubles(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// Median of a sorted array
+static double SortedMedian(const double *values, int count) {
+    return (count % 2) ? values[count/2] : 0.5 * (values[count/2 - 1] + values[count/2]);
+}
+
+// Build the fixed camera path, sprites and collision points inside the benchmark level
+static void BuildWorkload(const Maze *maze) {
+    RandomState rng;
+    SeedRandomState(&rng, BENCH_SEED);
+    float planeScale = tanf(DegToRad(FOV / 2.0f));
+
+    // Camera poses on walkable cells, as a player would see the maze
+    for (int i = 0; i < CAMERA_POSES; i++) {
+        int x, y;
+        do {
+            x = RandomNext(&rng) % MAZE_WIDTH;
+            y = RandomNext(&rng) % MAZE_HEIGHT;
+        } while (maze->grid[y][x] == CELL_WALL);
+
+        float angle = RandomFloat(&rng) * 2.0f * PI;
+        cameraPath[i].position = (Vector2){ x + 0.2f + 0.6f * RandomFloat(&rng), y + 0.2f + 0.6f * RandomFloat(&rng) };
+        cameraPath[i].dir = (Vector2){ cosf(angle), sinf(angle) };
+        cameraPath[i].plane = (Vector2){ -cameraPath[i].dir.y * planeScale, cameraPath[i].dir.x * planeScale };
+    }
+
+    for (int i = 0; i < BENCH_SPRITES; i++) {
+        spritePoints[i] = (Vector2){ RandomFloat(&rng) * MAZE_WIDTH, RandomFloat(&rng) * MAZE_HEIGHT };
+        spriteOrder[i] = i;
+    }
+
+    for (int i = 0; i < COLLISION_POINTS; i++) {
+        collisionPoints[i] = (Vector2){ RandomFloat(&rng) * MAZE_WIDTH, RandomFloat(&rng) * MAZE_HEIGHT };
+    }
+
+    // Angles and enemy-to-player offsets as the game feeds them to the fast math
+    for (int i = 0; i < MATH_SAMPLES; i++) {
+        mathAngles[i] = RandomFloat(&rng) * 2.0f * PI;
+        mathPoints[i] = (Vector2){ (RandomFloat(&rng) - 0.5f) * MAZE_WIDTH, (RandomFloat(&rng) - 0.5f) * MAZE_HEIGHT };
+    }
+
+    for (int i = 0; i < FLOOR_TEXTURE_SIZE * FLOOR_TEXTURE_SIZE; i++) {
+        unsigned char gray = (unsigned char)(RandomNext(&rng) & 255);
+        floorTexels[i] = (Color){ gray, gray, gray, 255 };
+    }
+
+    for (int i = 0; i < WALL_TEXTURE_SIZE * WALL_TEXTURE_SIZE; i++) {
+        unsigned int noise = RandomNext(&rng);
+        wallTexels[i] = (Color){ (unsigned char)(128 + (noise & 127)), (unsigned char)(64 + ((noise >> 8) & 63)),
+                                 (unsigned char)(32 + ((noise >> 16) & 31)), 255 };
+    }
+
+    // Ring sprite: transparent outside and inside, blended over one texel at both edges
+    for (int y = 0; y < SPRITE_TEXTURE_SIZE; y++) {
+        for (int x = 0; x < SPRITE_TEXTURE_SIZE; x++) {
+            float radius = hypotf(x + 0.5f - SPRITE_TEXTURE_SIZE / 2.0f, y + 0.5f - SPRITE_TEXTURE_SIZE / 2.0f);
+            float coverage = fminf(radius - 24.0f, 30.0f - radius) + 0.5f;
+            unsigned char alpha = (unsigned char)(255.0f * fminf(fmaxf(coverage, 0.0f), 1.0f));
+            spriteTexels[y * SPRITE_TEXTURE_SIZE + x] = (Color){ 200, 160, 40, alpha };
+        }
+    }
+
+    // Room of the wall kernels: walls only on the border, fully lit
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) {
+            bool border = (x == 0 || y == 0 || x == MAZE_WIDTH - 1 || y == MAZE_HEIGHT - 1);
+            wallRoom.grid[y][x] = border ? CELL_WALL : CELL_EMPTY;
+            wallRoom.light[y][x] = LIGHT_LEVELS - 1;
+        }
+    }
+}
+
+// Check the fast math against double precision libm, returns false if a documented error
+// bound (utils.h) is exceeded
+static bool CheckFastMath(void) {
+    double sinCosError = 0.0;
+    double atan2Error = 0.0;
+
+    // Dense sweep of [-2*PI, 2*PI]
+    for (int i = 0; i <= MATH_CHECK_SAMPLES; i++) {
+        float angle = (float)(-2.0 * PI + 4.0 * PI * i / MATH_CHECK_SAMPLES);
+        float sine, cosine;
+        FastSinCos(angle, &sine, &cosine);
+
+        double errors[4] = {
+            fabs(sine - sin(angle)), fabs(cosine - cos(angle)),
+            fabs(FastSin(angle) - sin(angle)), fabs(FastCos(angle) - cos(angle))
+        };
+        for (int e = 0; e < 4; e++) if (errors[e] > sinCosError) sinCosError = errors[e];
+    }
+
+    // Points around circles of several radii (both signs of zero excluded, atan2 differs there)
+    const float radii[] = { 1e-3f, 1.0f, 100.0f };
+    for (int r = 0; r < (int)(sizeof(radii)/sizeof(radii[0])); r++) {
+        for (int i = 1; i < MATH_CHECK_SAMPLES; i++) {
+            double angle = -PI + 2.0 * PI * i / MATH_CHECK_SAMPLES;
+            float y = (float)(radii[r] * sin(angle));
+            float x = (float)(radii[r] * cos(angle));
+
+            double error = fabs(FastAtan2(y, x) - atan2(y, x));
+            if (error > PI) error = fabs(error - 2.0 * PI);    // Same angle on both sides of -PI/PI
+            if (error > atan2Error) atan2Error = error;
+        }
+    }
+
+    fprintf(stderr, "fast math max error: sin/cos %.3g (bound %.3g), atan2 %.3g (bound %.3g)\n",
+            sinCosError, FAST_TRIG_MAX_ERROR, atan2Error, FAST_ATAN2_MAX_ERROR);
+
+    return (sinCosError <= FAST_TRIG_MAX_ERROR) && (atan2Error <= FAST_ATAN2_MAX_ERROR);
+}
+
+// Kernel: DDA column cast of every screen column along the camera path (ops = rays)
+static long KernelCastRays(void) {
+    const Maze *maze = BenchGetMaze();
+    float sum = 0.0f;
+
+    for (int pose = 0; pose < CAMERA_POSES; pose++) {
+        const CameraPose *camera = &cameraPath[pose];
+
+        for (int x = 0; x < SCREEN_COLUMNS; x++) {
+            float cameraX = 2.0f * x / SCREEN_COLUMNS - 1.0f;
+            Vector2 rayDir = { camera->dir.x + camera->plane.x * cameraX, camera->dir.y + camera->plane.y * cameraX };
+            RayHit hit = CastRay(maze, camera->position, rayDir, 20.0f);
+            sum += hit.distance;
+        }
+    }
+
+    sink = sum;
+    return (long)CAMERA_POSES * SCREEN_COLUMNS;
+}
+
+// Kernel: traversal pass filling the column buffer along the camera path (ops = columns)
+static long KernelTraceColumns(void) {
+    const Maze *maze = BenchGetMaze();
+    float sum = 0.0f;
+
+    for (int pose = 0; pose < CAMERA_POSES; pose++) {
+        const CameraPose *pathPose = &cameraPath[pose];
+        RayCamera camera = { pathPose->position, pathPose->dir, pathPose->plane, 0.0f };
+
+        TraceColumns(&columns, maze, &camera, SCREEN_ROWS, 64, 20.0f, castMode);
+        sum += columns.depth[pose];
+    }
+
+    sink = sum;
+    return (long)CAMERA_POSES * SCREEN_COLUMNS;
+}
+
+// Kernel: traversal pass of a camera turning in place at the start of the path (ops = columns)
+static long KernelTraceRotating(void) {
+    const Maze *maze = BenchGetMaze();
+    float planeScale = tanf(DegToRad(FOV / 2.0f));
+    float sum = 0.0f;
+
+    for (int pose = 0; pose < CAMERA_POSES; pose++) {
+        float angle = 2.0f * PI * pose / CAMERA_POSES;
+        RayCamera camera = { cameraPath[0].position, { cosf(angle), sinf(angle) }, { 0.0f, 0.0f }, 0.0f };
+        camera.plane = (Vector2){ -camera.dir.y * planeScale, camera.dir.x * planeScale };
+
+        TraceColumns(&columns, maze, &camera, SCREEN_ROWS, 64, 20.0f, castMode);
+        sum += columns.depth[pose];
+    }
+
+    sink = sum;
+    return (long)CAMERA_POSES * SCREEN_COLUMNS;
+}
+
+// Kernel: traversal pass of a camera stopping STILL_FRAMES frames at each pose of the path
+// (ops = columns)
+static long KernelTraceStill(void) {
+    const Maze *maze = BenchGetMaze();
+    float sum = 0.0f;
+
+    for (int frame = 0; frame < CAMERA_POSES; frame++) {
+        const CameraPose *pathPose = &cameraPath[frame / STILL_FRAMES];
+        RayCamera camera = { pathPose->position, pathPose->dir, pathPose->plane, 0.0f };
+
+        TraceColumns(&columns, maze, &camera, SCREEN_ROWS, 64, 20.0f, castMode);
+        sum += columns.depth[frame];
+    }
+
+    sink = sum;
+    return (long)CAMERA_POSES * SCREEN_COLUMNS;
+}
+
+// Kernel: textured floor and ceiling of a 1080p frame along the camera path (ops = frames)
+static long KernelSoftFloor(void) {
+    for (int pose = 0; pose < FLOOR_FRAMES; pose++) {
+        SoftCamera camera = { cameraPath[pose].position, cameraPath[pose].dir, cameraPath[pose].plane };
+        SoftRenderFloor(&floorFrame, BenchGetMaze(), &camera, &floorImage, &floorImage, &shades);
+    }
+
+    sink = floorFrame.pixels[FLOOR_WIDTH * (FLOOR_HEIGHT - 1)].r;
+    return FLOOR_FRAMES;
+}
+
+// Kernel: textured walls of a 1080p frame facing a wall wallDistance cells away, the camera
+// steps sideways between frames (ops = frames)
+static long KernelSoftWalls(void) {
+    float planeScale = tanf(DegToRad(FOV / 2.0f));
+
+    for (int frame = 0; frame < WALL_FRAMES; frame++) {
+        SoftCamera camera = { { MAZE_WIDTH / 2.0f + 0.1f * frame, (float)(MAZE_HEIGHT - 1 - wallDistance) },
+                              { 0.0f, 1.0f }, { -planeScale, 0.0f } };
+        SoftRenderWalls(&floorFrame, &wallColumns, &wallRoom, &camera, wallTexture, 20.0f, CAST_COHERENT, &shades);
+    }
+
+    sink = floorFrame.pixels[FLOOR_WIDTH * (FLOOR_HEIGHT / 2)].r;
+    return WALL_FRAMES;
+}
+
+// Kernel: a ring sprite drawn over a 1080p frame wallDistance cells in front of the camera,
+// which steps sideways between frames (ops = frames)
+static long KernelSoftSprite(void) {
+    float planeScale = tanf(DegToRad(FOV / 2.0f));
+    int order[1] = { 0 };
+
+    for (int frame = 0; frame < SPRITE_FRAMES; frame++) {
+        SoftCamera camera = { { MAZE_WIDTH / 2.0f + 0.01f * frame, benchSprite.position.y - wallDistance },
+                              { 0.0f, 1.0f }, { -planeScale, 0.0f } };
+        SoftRenderSprites(&floorFrame, spriteDepths, &benchSprite, 1, order, &camera, &shades);
+    }
+
+    sink = floorFrame.pixels[FLOOR_WIDTH * (FLOOR_HEIGHT / 2)].r;
+    return SPRITE_FRAMES;
+}
+
+// Kernel: sprite sort and camera transform along the camera path (ops = frames)
+static long KernelSprites(void) {
+    float sum = 0.0f;
+
+    for (int pose = 0; pose < CAMERA_POSES; pose++) {
+        const CameraPose *camera = &cameraPath[pose];
+
+        SortByDistance(spritePoints, BENCH_SPRITES, camera->position, spriteOrder);
+        for (int i = 0; i < BENCH_SPRITES; i++) {
+            Vector2 transform = TransformToCamera(spritePoints[spriteOrder[i]], camera->position, camera->dir, camera->plane);
+            if (transform.y > 0) sum += transform.x / transform.y;
+        }
+    }
+
+    sink = sum;
+    return CAMERA_POSES;
+}
+
+// Reset the sprite order so every sprite run sorts from the same permutation
+static void PrepareSprites(void) {
+    for (int i = 0; i < BENCH_SPRITES; i++) spriteOrder[i] = i;
+}
+
+// Kernel: maze generation at the current size (ops = mazes)
+static long KernelGenerateMaze(void) {
+    Vector2 start, exit;
+    int mazes = (mazeSize <= 31) ? 64 : 8;
+
+    for (int i = 0; i < mazes; i++) {
+        GenerateMazeGrid(mazeCells, mazeSize, mazeSize, mazeSeed + i * 2654435761u, &start, &exit);
+    }
+
+    sink = exit.x;
+    return mazes;
+}
+
+// Kernel: player collision tests (ops = tests)
+static long KernelWallCollision(void) {
+    int collisions = 0;
+
+    for (int i = 0; i < COLLISION_POINTS; i++) {
+        if (BenchCheckWallCollision(collisionPoints[i])) collisions++;
+    }
+
+    sink = (float)collisions;
+    return COLLISION_POINTS;
+}
+
+// Kernel: enemy AI, animation and attacks (ops = simulation steps)
+static long KernelUpdateEnemies(void) {
+    for (int i = 0; i < ENEMY_STEPS; i++) {
+        BenchUpdateEnemies(SIM_DT);
+    }
+
+    return ENEMY_STEPS;
+}
+
+// Kernel: table-driven sine and cosine (ops = angles)
+static long KernelFastSinCos(void) {
+    float sum = 0.0f;
+
+    for (int i = 0; i < MATH_SAMPLES; i++) {
+        float sine, cosine;
+        FastSinCos(mathAngles[i], &sine, &cosine);
+        sum += sine + cosine;
+    }
+
+    sink = sum;
+    return MATH_SAMPLES;
+}
+
+// Kernel: libm sine and cosine, reference for the fast version (ops = angles)
+static long KernelLibmSinCos(void) {
+    float sum = 0.0f;
+
+    for (int i = 0; i < MATH_SAMPLES; i++) sum += sinf(mathAngles[i]) + cosf(mathAngles[i]);
+
+    sink = sum;
+    return MATH_SAMPLES;
+}
+
+// Kernel: approximate atan2 (ops = points)
+static long KernelFastAtan2(void) {
+    float sum = 0.0f;
+
+    for (int i = 0; i < MATH_SAMPLES; i++) sum += FastAtan2(mathPoints[i].y, mathPoints[i].x);
+
+    sink = sum;
+    return MATH_SAMPLES;
+}
+
+// Kernel: libm atan2, reference for the fast version (ops = points)
+static long KernelLibmAtan2(void) {
+    float sum = 0.0f;
+
+    for (int i = 0; i < MATH_SAMPLES; i++) sum += atan2f(mathPoints[i].y, mathPoints[i].x);
+
+    sink = sum;
+    return MATH_SAMPLES;
+}
+
+// Time a kernel and print its CSV row
+static void Measure(const char *name, int param, void (*prepare)(void), long (*kernel)(void)) {
+    static double samples[MAX_REPS];
+    static double deviations[MAX_REPS];
+
+    if (filter != NULL && strstr(name, filter) == NULL) return;
+
+    for (int i = 0; i < warmupRuns; i++) {
+        if (prepare != NULL) prepare();
+        kernel();
+    }
+
+    long ops = 0;
+    for (int i = 0; i < repetitions; i++) {
+        if (prepare != NULL) prepare();
+
+        double start = ReadClock();
+        ops = kernel();
+        samples[i] = (ReadClock() - start) / ops;
+    }
+
+    qsort(samples, repetitions, sizeof(double), CompareDoubles);
+    double median = SortedMedian(samples, repetitions);
+
+    for (int i = 0; i < repetitions; i++) deviations[i] = (samples[i] > median) ? samples[i] - median : median - samples[i];
+    qsort(deviations, repetitions, sizeof(double), CompareDoubles);
+    double mad = SortedMedian(deviations, repetitions);
+
+    printf("%s,%d,%d,%ld,%.3f,%.3f,%.3f\n", name, param, repetitions, ops, median, mad, samples[0]);
+    fflush(stdout);
+}
+
+// ----------------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupRuns = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            printf("Usage: %s [--reps N] [--warmup N] [--filter text]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (repetitions < 1) repetitions = 1;
+    if (repetitions > MAX_REPS) repetitions = MAX_REPS;
+    if (warmupRuns < 0) warmupRuns = 0;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    // Fixed level: the game's first level for the benchmark seed
+    BenchStartLevel(BENCH_SEED);
+    BuildWorkload(BenchGetMaze());
+
+    // The game relies on these bounds, a build that breaks them fails the benchmark
+    if (!CheckFastMath()) {
+        fprintf(stderr, "Fast math error bounds exceeded\n");
+        CloseGame();
+        return 1;
+    }
+
+    printf("kernel,param,reps,ops_per_rep,median_ns_per_op,mad_ns_per_op,min_ns_per_op\n");
+
+    Measure("dda_cast_ray", SCREEN_COLUMNS, NULL, KernelCastRays);
+    if (ReserveColumnBuffer(&columns, SCREEN_COLUMNS)) {
+        castMode = CAST_DDA;
+        Measure("trace_columns_dda", SCREEN_COLUMNS, NULL, KernelTraceColumns);
+        castMode = CAST_COHERENT;
+        Measure("trace_columns_coherent", SCREEN_COLUMNS, NULL, KernelTraceColumns);
+        Measure("trace_rotating_coherent", SCREEN_COLUMNS, NULL, KernelTraceRotating);
+        Measure("trace_still_coherent", SCREEN_COLUMNS, NULL, KernelTraceStill);
+        castMode = CAST_CACHED;
+        Measure("trace_rotating_cached", SCREEN_COLUMNS, NULL, KernelTraceRotating);
+        Measure("trace_still_cached", SCREEN_COLUMNS, NULL, KernelTraceStill);
+    }
+    Measure("sprite_sort_transform", BENCH_SPRITES, PrepareSprites, KernelSprites);
+
+    const int mazeSizes[] = { 15, 31, 63, MAX_BENCH_MAZE };
+    for (int i = 0; i < (int)(sizeof(mazeSizes)/sizeof(mazeSizes[0])); i++) {
+        mazeSize = mazeSizes[i];
+        mazeSeed = BENCH_SEED + mazeSize;
+        Measure("generate_maze", mazeSize, NULL, KernelGenerateMaze);
+    }
+
+    Measure("check_wall_collision", COLLISION_POINTS, NULL, KernelWallCollision);
+    Measure("update_enemies", ENEMY_STEPS, BenchRestoreLevel, KernelUpdateEnemies);
+    Measure("fast_sincos", MATH_SAMPLES, NULL, KernelFastSinCos);
+    Measure("libm_sincos", MATH_SAMPLES, NULL, KernelLibmSinCos);
+    Measure("fast_atan2", MATH_SAMPLES, NULL, KernelFastAtan2);
+    Measure("libm_atan2", MATH_SAMPLES, NULL, KernelLibmAtan2);
+
+    // Floor casting on the calling thread, then with the workers (param = worker threads)
+    floorFrame = LoadSoftFrame(FLOOR_WIDTH, FLOOR_HEIGHT);
+    BuildShadeTable(&shades, FOG_START, FOG_END);
+    if (floorFrame.pixels != NULL) {
+        Measure("soft_floor_1080p", 0, NULL, KernelSoftFloor);
+        int workers = StartWorkers((int)sysconf(_SC_NPROCESSORS_ONLN) - 1);
+        if (workers > 0) Measure("soft_floor_1080p", workers, NULL, KernelSoftFloor);
+        StopWorkers();
+
+        // Wall columns at several distances (param = cells): near walls stretch every column
+        // over the screen, far ones shrink it to a few rows of a small mip
+        const Image *wallImages[1] = { &wallImage };
+        wallTextures[0] = LoadSoftTexture(&wallImage, true);
+        wallTextures[1] = LoadSoftTexture(&wallImage, false);
+        if (BuildPalette(wallImages, 1, &wallPalette)) {
+            wallIndexed = QuantizeImage(&wallImage, &wallPalette);
+            BuildColormaps(&wallColormaps, &wallPalette, &shades);
+            if (wallIndexed.indices != NULL) wallTextures[2] = MakeIndexedSoftTexture(&wallIndexed, &wallColormaps);
+        }
+
+        const char *wallKernels[3] = { "soft_walls_1080p_mips", "soft_walls_1080p_nomips", "soft_walls_1080p_pal8" };
+        const int wallDistances[] = { 1, 2, 4, 8, 12 };
+        for (int t = 0; t < 3; t++) {
+            if (wallTextures[t].memory == NULL && wallTextures[t].indexed == NULL) continue;
+
+            wallTexture = &wallTextures[t];
+            for (int i = 0; i < (int)(sizeof(wallDistances)/sizeof(wallDistances[0])); i++) {
+                wallDistance = wallDistances[i];
+                Measure(wallKernels[t], wallDistance, NULL, KernelSoftWalls);
+            }
+        }
+
+        // Sprite columns at several distances (param = cells): posts visit only the texels that
+        // show, the alpha tested path every row of the sprite
+        const Image *spriteImages[1] = { &spriteImage };
+        spriteTextures[0] = LoadSoftTexture(&spriteImage, false);
+        spriteTextures[1] = spriteTextures[0];
+        spriteTextures[1].posts = NULL;
+        if (BuildPalette(spriteImages, 1, &spritePalette)) {
+            spriteIndexed = QuantizeImage(&spriteImage, &spritePalette);
+            BuildColormaps(&spriteColormaps, &spritePalette, &shades);
+            if (spriteIndexed.indices != NULL) spriteTextures[2] = MakeIndexedSoftTexture(&spriteIndexed, &spriteColormaps);
+        }
+        spriteTextures[3] = spriteTextures[2];
+        spriteTextures[3].posts = NULL;
+        for (int x = 0; x < FLOOR_WIDTH; x++) spriteDepths[x] = 1e30f;
+        benchSprite = (SoftSprite){ { MAZE_WIDTH / 2.0f, MAZE_HEIGHT - 2.0f }, CELL_ENEMY, { 0 }, LIGHT_LEVELS - 1 };
+
+        const char *spriteKernels[4] = { "soft_sprite_1080p_posts", "soft_sprite_1080p_alpha",
+                                         "soft_sprite_1080p_pal8_posts", "soft_sprite_1080p_pal8_alpha" };
+        const int spriteDistances[] = { 1, 2, 4, 8 };
+        for (int t = 0; t < 4; t++) {
+            if (spriteTextures[t].memory == NULL && spriteTextures[t].indexed == NULL) continue;
+
+            benchSprite.texture = spriteTextures[t];
+            for (int i = 0; i < (int)(sizeof(spriteDistances)/sizeof(spriteDistances[0])); i++) {
+                wallDistance = spriteDistances[i];
+                Measure(spriteKernels[t], wallDistance, NULL, KernelSoftSprite);
+            }
+        }
+
+        UnloadSoftTexture(&spriteTextures[0]);
+        UnloadSoftTexture(&spriteTextures[2]);
+        if (spriteIndexed.indices != NULL) UnloadIndexedImage(&spriteIndexed);
+        UnloadSoftTexture(&wallTextures[0]);
+        UnloadSoftTexture(&wallTextures[1]);
+        UnloadSoftTexture(&wallTextures[2]);
+        if (wallIndexed.indices != NULL) UnloadIndexedImage(&wallIndexed);
+        FreeColumnBuffer(&wallColumns);
+        UnloadSoftFrame(&floorFrame);
+    }
+
+    FreeColumnBuffer(&columns);
+    CloseGame();
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************************
+*
+*   headless - Runs the MazeRay simulation without window, GPU or audio
+*
+*   Usage: headless [--ticks N] [--seed S] [--replay file]
+*
+*   A bot drives the game through the input source hook: it wanders and shoots, starts a
+*   new game on the title screen and restarts after every victory or game over. Steps run
+*   back to back as fast as the CPU allows and the simulated ticks/sec are reported at the
+*   end, which makes it usable for soak tests of the enemy and maze logic. With --replay the
+*   recorded session is simulated instead of the bot (ticks and seed come from the replay).
+*
+*******************************************************************************************/
+
+#include "raylib.h"
+#include "../src/game.h"
+#include "../src/utils.h"
+#include "../src/replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_TICKS   (SIM_TICK_RATE * 60 * 10)   // Ten simulated minutes
+#define DEFAULT_SEED    12345
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static RandomState botRng;
+static unsigned int botActions = 0;     // Movement actions currently held
+static int botHoldTicks = 0;            // Ticks left before picking new actions
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Monotonic wall clock in seconds
+static double GetWallTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Bot input: exactly one simulation step per call
+static GameInput BotInput(void) {
+    GameInput input = { 0 };
+    input.deltaTime = SIM_DT;
+
+    switch (GetGameState()) {
+        case GAME_TITLE:
+            input.pressed = INPUT_START;
+            break;
+
+        case GAME_VICTORY:
+        case GAME_OVER:
+            input.pressed = INPUT_RESTART;
+            break;
+
+        case GAME_PAUSED:
+            input.pressed = INPUT_PAUSE;
+            break;
+
+        case GAME_PLAYING:
+            // Mostly walk forward, turning now and then
+            if (--botHoldTicks <= 0) {
+                float choice = RandomFloat(&botRng);
+                botActions = INPUT_FORWARD;
+                if (choice < 0.25f) botActions |= INPUT_TURN_LEFT;
+                else if (choice < 0.5f) botActions |= INPUT_TURN_RIGHT;
+                else if (choice < 0.6f) botActions = INPUT_BACKWARD;
+                botHoldTicks = 10 + (int)(RandomFloat(&botRng) * SIM_TICK_RATE);
+            }
+            input.down = botActions;
+
+            if (RandomFloat(&botRng) < 0.05f) {
+                input.down |= INPUT_SHOOT;
+                input.pressed |= INPUT_SHOOT;
+            }
+            break;
+    }
+
+    return input;
+}
+
+// Replay input: the recorded frames, simulated back to back
+static GameInput ReplayInput(void) {
+    GameInput input;
+    ReadReplayFrame(&input);
+    return input;
+}
+
+// ----------------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    unsigned int ticks = DEFAULT_TICKS;
+    unsigned int seed = DEFAULT_SEED;
+    const char *replayFile = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayFile = argv[++i];
+        } else {
+            printf("Usage: %s [--ticks N] [--seed S] [--replay file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    SeedRandomState(&botRng, seed);
+
+    if (replayFile != NULL) {
+        if (!OpenReplay(replayFile)) return 1;
+        seed = GetReplaySeed();
+    }
+
+    SetGameHeadless(true);
+    SetGameSeed(seed);
+    SetGameInputSource((replayFile != NULL) ? ReplayInput : BotInput);
+    InitGame();
+
+    // Count how every game ended
+    int games = 0;
+    int victories = 0;
+    int defeats = 0;
+    GameState lastState = GetGameState();
+
+    double startTime = GetWallTime();
+
+    while ((replayFile != NULL) ? !IsReplayFinished() : (GetGameTicks() < ticks)) {
+        UpdateGame();
+
+        GameState state = GetGameState();
+        if (state != lastState) {
+            if (state == GAME_PLAYING && lastState != GAME_PAUSED) games++;
+            else if (state == GAME_VICTORY) victories++;
+            else if (state == GAME_OVER) defeats++;
+            lastState = state;
+        }
+    }
+
+    double elapsed = GetWallTime() - startTime;
+    ticks = GetGameTicks();
+
+    CloseGame();
+    CloseReplay();
+
+    printf("Simulated %u ticks (%.1f s of game time) in %.3f s\n", ticks, (double)ticks * SIM_DT, elapsed);
+    printf("Ticks/sec: %.0f (%.1fx real time)\n", (elapsed > 0.0) ? ticks / elapsed : 0.0,
+           (elapsed > 0.0) ? (double)ticks * SIM_DT / elapsed : 0.0);
+    printf("Games: %d, victories: %d, game overs: %d\n", games, victories, defeats);
+
+    return 0;
+}
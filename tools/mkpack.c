@@ -0,0 +1,232 @@
+/*******************************************************************************************
+*
+*   mkpack - Builds the MazeRay asset archive
+*
+*   Usage: mkpack [--palette] <output.pak> <asset files...>
+*
+*   Images are decoded and stored as RGBA8 pixels, sounds are decoded and stored as raw
+*   PCM samples, so the game only has to map the archive and upload the data.
+*   With --palette every image is also quantized to one shared 256-color palette, and the
+*   palette and the column-major 8-bit indices of each image are stored too (see pack.h).
+*
+*******************************************************************************************/
+
+#include "raylib.h"
+#include "../src/pack.h"
+#include "../src/palette.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Decoded asset waiting to be written
+typedef struct {
+    PackEntry entry;
+    Image image;
+    Wave wave;
+    IndexedImage indexed;
+    const void *data;
+} PackItem;
+
+static Palette palette;     // Shared palette of --palette
+
+// Check the extension of a file name (case sensitive, assets are lowercase)
+static bool HasExtension(const char *fileName, const char *ext) {
+    size_t nameLen = strlen(fileName);
+    size_t extLen = strlen(ext);
+    return nameLen > extLen && strcmp(fileName + nameLen - extLen, ext) == 0;
+}
+
+// Sort items by name so the game can binary search the table of contents
+static int CompareItems(const void *a, const void *b) {
+    return strncmp(((const PackItem *)a)->entry.name, ((const PackItem *)b)->entry.name, PACK_NAME_SIZE);
+}
+
+// Round an offset up to the archive alignment
+static uint32_t AlignOffset(uint64_t offset) {
+    return (uint32_t)((offset + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT);
+}
+
+// Decode one asset file into a pack item
+static bool DecodeItem(PackItem *item, const char *fileName) {
+    memset(item, 0, sizeof(PackItem));
+
+    if (strlen(fileName) >= PACK_NAME_SIZE) {
+        printf("Asset path too long (max %d): %s\n", PACK_NAME_SIZE - 1, fileName);
+        return false;
+    }
+    strcpy(item->entry.name, fileName);
+
+    if (HasExtension(fileName, ".png")) {
+        item->image = LoadImage(fileName);
+        if (item->image.data == NULL) return false;
+
+        ImageFormat(&item->image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        item->entry.type = PACK_ENTRY_IMAGE;
+        item->entry.width = item->image.width;
+        item->entry.height = item->image.height;
+        item->entry.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        item->entry.size = item->image.width * item->image.height * 4;
+        item->data = item->image.data;
+    } else if (HasExtension(fileName, ".wav") || HasExtension(fileName, ".mp3") || HasExtension(fileName, ".ogg")) {
+        item->wave = LoadWave(fileName);
+        if (item->wave.data == NULL) return false;
+
+        item->entry.type = PACK_ENTRY_WAVE;
+        item->entry.width = item->wave.frameCount;
+        item->entry.height = item->wave.sampleRate;
+        item->entry.format = (uint16_t)item->wave.sampleSize;
+        item->entry.channels = (uint16_t)item->wave.channels;
+        item->entry.size = item->wave.frameCount * item->wave.channels * (item->wave.sampleSize / 8);
+        item->data = item->wave.data;
+    } else {
+        printf("Unsupported asset type: %s\n", fileName);
+        return false;
+    }
+
+    return true;
+}
+
+// Unload the decoded data of the items and free them (items that failed to decode hold none)
+static void FreeItems(PackItem *items, int count) {
+    for (int i = 0; i < count; i++) {
+        if (items[i].entry.type == PACK_ENTRY_IMAGE) UnloadImage(items[i].image);
+        else if (items[i].entry.type == PACK_ENTRY_WAVE) UnloadWave(items[i].wave);
+        else if (items[i].entry.type == PACK_ENTRY_INDEXED) UnloadIndexedImage(&items[i].indexed);
+    }
+
+    free(items);
+}
+
+// Quantize the decoded images to a shared palette and add the palette and the indices of
+// every image as items (items must have room for them), returns the new item count (-1 on error)
+static int AddPaletteItems(PackItem *items, int itemCount) {
+    const Image **images = calloc(itemCount, sizeof(const Image *));
+    if (images == NULL) return -1;
+
+    int imageCount = 0;
+    for (int i = 0; i < itemCount; i++) {
+        if (items[i].entry.type == PACK_ENTRY_IMAGE) images[imageCount++] = &items[i].image;
+    }
+
+    if (!BuildPalette(images, imageCount, &palette)) {
+        free(images);
+        return -1;
+    }
+    free(images);
+
+    int count = itemCount;
+    for (int i = 0; i < itemCount; i++) {
+        if (items[i].entry.type != PACK_ENTRY_IMAGE) continue;
+
+        PackItem *item = &items[count];
+        memset(item, 0, sizeof(PackItem));
+        if (strlen(items[i].entry.name) + strlen(PACK_INDEXED_SUFFIX) >= PACK_NAME_SIZE) {
+            printf("Asset path too long (max %d): %s%s\n", PACK_NAME_SIZE - 1, items[i].entry.name, PACK_INDEXED_SUFFIX);
+            return -1;
+        }
+        strcpy(item->entry.name, items[i].entry.name);
+        strcat(item->entry.name, PACK_INDEXED_SUFFIX);
+
+        item->indexed = QuantizeImage(&items[i].image, &palette);
+        if (item->indexed.indices == NULL) return -1;
+
+        item->entry.type = PACK_ENTRY_INDEXED;
+        item->entry.width = item->indexed.width;
+        item->entry.height = item->indexed.height;
+        item->entry.size = item->indexed.width * item->indexed.height;
+        item->data = item->indexed.indices;
+        count++;
+    }
+
+    PackItem *item = &items[count++];
+    memset(item, 0, sizeof(PackItem));
+    strcpy(item->entry.name, PACK_PALETTE_NAME);
+    item->entry.type = PACK_ENTRY_PALETTE;
+    item->entry.width = palette.count;
+    item->entry.height = 1;
+    item->entry.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    item->entry.size = sizeof(palette.colors);
+    item->data = palette.colors;
+
+    return count;
+}
+
+int main(int argc, char *argv[]) {
+    bool palettized = (argc > 1 && strcmp(argv[1], "--palette") == 0);
+    int first = palettized ? 2 : 1;
+
+    if (argc - first < 2) {
+        printf("Usage: %s [--palette] <output.pak> <asset files...>\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    const char *outputFile = argv[first];
+    int itemCount = argc - first - 1;
+    int itemCapacity = 2 * itemCount + 1;   // Room for the indices of every image and the palette
+    PackItem *items = calloc(itemCapacity, sizeof(PackItem));
+    if (items == NULL) {
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    for (int i = 0; i < itemCount; i++) {
+        if (!DecodeItem(&items[i], argv[first + 1 + i])) {
+            printf("Error decoding asset: %s\n", argv[first + 1 + i]);
+            FreeItems(items, itemCapacity);
+            return 1;
+        }
+    }
+
+    if (palettized) {
+        itemCount = AddPaletteItems(items, itemCount);
+        if (itemCount < 0) {
+            printf("Error quantizing the images\n");
+            FreeItems(items, itemCapacity);
+            return 1;
+        }
+    }
+
+    qsort(items, itemCount, sizeof(PackItem), CompareItems);
+
+    // Assign aligned offsets after the header and the table of contents
+    PackHeader header = { 0 };
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.entryCount = itemCount;
+    header.tocOffset = sizeof(PackHeader);
+
+    uint64_t offset = sizeof(PackHeader) + (uint64_t)itemCount * sizeof(PackEntry);
+    for (int i = 0; i < itemCount; i++) {
+        items[i].entry.offset = AlignOffset(offset);
+        offset = (uint64_t)items[i].entry.offset + items[i].entry.size;
+    }
+    header.fileSize = offset;
+
+    FILE *file = fopen(outputFile, "wb");
+    if (file == NULL) {
+        printf("Error creating archive: %s\n", outputFile);
+        FreeItems(items, itemCount);
+        return 1;
+    }
+
+    fwrite(&header, sizeof(PackHeader), 1, file);
+    for (int i = 0; i < itemCount; i++) {
+        fwrite(&items[i].entry, sizeof(PackEntry), 1, file);
+    }
+
+    static const unsigned char padding[PACK_ALIGNMENT] = { 0 };
+    for (int i = 0; i < itemCount; i++) {
+        long position = ftell(file);
+        fwrite(padding, 1, items[i].entry.offset - position, file);
+        fwrite(items[i].data, 1, items[i].entry.size, file);
+    }
+
+    fclose(file);
+    FreeItems(items, itemCount);
+
+    printf("Packed %d assets into %s (%llu bytes)\n", itemCount, outputFile, (unsigned long long)header.fileSize);
+
+    return 0;
+}
@@ -0,0 +1,648 @@
+/*******************************************************************************************
+*
+*   renderbench - Offscreen render harness of the MazeRay raycaster (no window, GPU or assets)
+*
+*   Usage: renderbench [--width W] [--height H] [--frames N] [--ppm dir]
+*                      [--goldens file] [--update-goldens] [--cast dda|coherent|cached]
+*                      [--threads N] [--palette] [--pack file]
+*
+*   The floor, ceiling, walls and sprites of a fixed level are rendered by the software renderer along a
+*   scripted camera path (turns in place, walks along the corridors and looks around every
+*   few cells). Textures are generated procedurally, so the output only depends on the code.
+*   The render time per frame is reported and every frame is hashed (FNV-1a over the RGBA
+*   pixels). The hashes are compared with the stored goldens for the same resolution, so an
+*   optimization of the casting or drawing code must keep the output pixel-exact. A frame
+*   without a golden fails too; when the output changes on purpose or a resolution or frame
+*   count is added, --update-goldens rewrites the goldens of that resolution.
+*   With --ppm every frame is also written as dir/frame_NNNN.ppm. --cast selects how the wall
+*   columns are traced (cached by default, as in the game, coherent without reusing anything
+*   between frames and dda casting every column): all of them must match the same goldens.
+*   --threads sets the worker threads drawing the floor rows (default: one less than the
+*   CPUs, the main thread works too); the output doesn't depend on it. --palette quantizes the
+*   wall and sprite textures to a shared 256-color palette and draws them from 8-bit indices
+*   through colormaps (palette.h); its output is checked against a goldens file of its own.
+*   --pack draws the game's wall, key, enemy and door textures from an asset archive instead
+*   (with --palette, the palette and indices mkpack --palette stored in it, used in place);
+*   their frames are only checked against goldens given with --goldens.
+*
+*******************************************************************************************/
+
+#include "raylib.h"
+#include "../src/game.h"
+#include "../src/maze.h"
+#include "../src/pack.h"
+#include "../src/softrender.h"
+#include "../src/utils.h"
+#include "../src/workers.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RENDER_SEED         20240601u
+#define DEFAULT_WIDTH       640
+#define DEFAULT_HEIGHT      360
+#define DEFAULT_FRAMES      480
+#define DEFAULT_GOLDENS     "tools/render_goldens.txt"
+#define PALETTE_GOLDENS     "tools/render_goldens_pal8.txt"
+
+#define TEXTURE_SIZE        64
+#define MAX_PATH_CELLS      (MAZE_WIDTH * MAZE_HEIGHT)
+#define MAX_RENDER_SPRITES  16
+#define MAX_GOLDENS         8192
+#define MAX_DISTANCE        (FOG_END + 1.5f)    // Farther walls are black (a ray that hits nothing stops
+                                                // less than sqrt(2) cells short of its limit)
+
+// Camera script
+#define TURN_FRAMES         6       // Frames to face the next cell (rotation only)
+#define MOVE_FRAMES         8       // Frames to walk to the next cell
+#define LOOK_AROUND_CELLS   4       // Look around every this many cells
+#define LOOK_AROUND_FRAMES  24      // Frames of a full turn (rotation only)
+
+// Wall and sprite textures
+typedef enum {
+    TEXTURE_WALL = 0,
+    TEXTURE_KEY,
+    TEXTURE_ENEMY,
+    TEXTURE_DOOR,
+    TEXTURE_COUNT
+} TextureId;
+
+// Game textures used by --pack, by TextureId
+static const char *textureAssets[TEXTURE_COUNT] = {
+    "assets/textures/wall.png", "assets/textures/key.png", "assets/textures/imp/tile000.png",
+    "assets/textures/door_closed.png"
+};
+
+// Stored hash of one frame
+typedef struct {
+    int width;
+    int height;
+    int frame;
+    unsigned long long hash;
+} Golden;
+
+// ----------------------------------------------------------------------------------
+// Global Variables
+// ----------------------------------------------------------------------------------
+static Maze maze;
+static Image wallImage;
+static Image floorImage;
+static Image ceilingImage;
+static Image keyImage;
+static Image enemyImage;
+static Image doorImage;
+static ShadeTable shades;
+static SoftTexture textures[TEXTURE_COUNT];     // What the renderer draws (RGBA or palettized)
+static IndexedImage indexedImages[TEXTURE_COUNT];
+static bool packIndices = false;                // indexedImages point into the asset archive
+static Image packImages[TEXTURE_COUNT];         // Pixels of textureAssets, mapped from the archive
+static Palette palette;
+static Colormaps colormaps;
+static SoftSprite sprites[MAX_RENDER_SPRITES];
+static int spriteOrder[MAX_RENDER_SPRITES];
+static int spriteCount = 0;
+
+static Vector2 pathCells[MAX_PATH_CELLS];
+static int pathLength = 0;
+
+static Golden goldens[MAX_GOLDENS];
+static int goldenCount = 0;
+
+// ----------------------------------------------------------------------------------
+// Local Functions (private)
+// ----------------------------------------------------------------------------------
+
+// Monotonic clock in milliseconds
+static double ReadClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6;
+}
+
+// Sort helper for medians
+static int CompareDoubles(const void *a, const void *b) {
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// Integer hash used for the texture noise
+static unsigned int HashCoords(unsigned int x, unsigned int y) {
+    unsigned int h = x * 374761393u + y * 668265263u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    return h ^ (h >> 16);
+}
+
+// Allocate an R8G8B8A8 image of TEXTURE_SIZE x TEXTURE_SIZE
+static Image AllocImage(void) {
+    Image image = { 0 };
+    image.data = calloc(TEXTURE_SIZE * TEXTURE_SIZE, sizeof(Color));
+    image.width = TEXTURE_SIZE;
+    image.height = TEXTURE_SIZE;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    return image;
+}
+
+// Set one pixel of an image made by AllocImage
+static void SetPixel(Image *image, int x, int y, Color color) {
+    ((Color *)image->data)[y * image->width + x] = color;
+}
+
+// Procedural textures: bricks for the walls, flagstones and planks for the floor and ceiling,
+// and sprites with transparent and
+// semi-transparent texels so the blending is covered too
+static void GenerateTextures(void) {
+    wallImage = AllocImage();
+    floorImage = AllocImage();
+    ceilingImage = AllocImage();
+    keyImage = AllocImage();
+    enemyImage = AllocImage();
+    doorImage = AllocImage();
+
+    for (int y = 0; y < TEXTURE_SIZE; y++) {
+        for (int x = 0; x < TEXTURE_SIZE; x++) {
+            unsigned int noise = HashCoords(x, y) & 31;
+
+            // Bricks of 32x16 with rows offset by half a brick
+            int row = y / 16;
+            int bx = (x + (row % 2) * 16) % TEXTURE_SIZE;
+            bool mortar = (y % 16) < 2 || (bx % 32) < 2;
+            unsigned int brick = HashCoords((x + (row % 2) * 16) / 32, row) & 63;
+            Color wall = mortar ? (Color){ 120 + noise, 120 + noise, 110 + noise, 255 }
+                                : (Color){ 130 + brick + noise, 50 + noise, 40 + brick / 2, 255 };
+            SetPixel(&wallImage, x, y, wall);
+
+            // Floor: four flagstones per cell with dark joints
+            bool joint = (x % 32) < 1 || (y % 32) < 1;
+            unsigned int stone = HashCoords(x / 32 + 11, y / 32 + 5) & 15;
+            SetPixel(&floorImage, x, y, joint ? (Color){ 30, 30, 32, 255 }
+                                              : (Color){ 70 + stone + noise, 68 + stone + noise, 64 + noise, 255 });
+
+            // Ceiling: planks along x
+            unsigned int board = HashCoords(y / 8, 3) & 15;
+            SetPixel(&ceilingImage, x, y, (y % 8 == 0) ? (Color){ 20, 16, 12, 255 }
+                                                       : (Color){ 45 + board + noise / 2, 35 + board, 25, 255 });
+
+            // Key: ring and shaft
+            float dx = x - 32.0f;
+            float dy = y - 20.0f;
+            float ring = dx*dx + dy*dy;
+            bool key = (ring >= 64.0f && ring <= 144.0f) || (x >= 30 && x < 34 && y >= 30 && y < 56) ||
+                       (x >= 34 && x < 42 && (y == 46 || y == 47 || y == 52 || y == 53));
+            SetPixel(&keyImage, x, y, key ? (Color){ 230, 190 + noise, 40, 255 } : BLANK);
+
+            // Enemy: body with a soft (semi-transparent) edge and two eyes
+            dx = x - 32.0f;
+            dy = y - 36.0f;
+            float body = dx*dx + dy*dy;
+            Color enemy = BLANK;
+            if (body < 400.0f) enemy = (Color){ 160 + noise, 30, 30, 255 };
+            else if (body < 576.0f) enemy = (Color){ 120, 20, 20, 128 };
+            if ((x - 24) * (x - 24) + (y - 30) * (y - 30) < 12 || (x - 40) * (x - 40) + (y - 30) * (y - 30) < 12) {
+                enemy = (Color){ 255, 240, 80, 255 };
+            }
+            SetPixel(&enemyImage, x, y, enemy);
+
+            // Door: vertical planks with a frame
+            bool frame = x < 4 || x >= 60 || y < 4;
+            unsigned int plank = HashCoords(x / 8, 7) & 15;
+            Color door = frame ? (Color){ 70, 70, 80, 255 } : (Color){ 100 + plank + noise, 60 + noise / 2, 30, 255 };
+            if (!frame && x % 8 == 0) door = (Color){ 50, 30, 15, 255 };
+            SetPixel(&doorImage, x, y, door);
+        }
+    }
+}
+
+// Hand the wall and sprite textures to the renderer transposed (the wall with mips), or
+// quantized to one palette at runtime, returns false if there is no memory
+static bool PrepareTextures(const Image *const *images, bool palettized) {
+    if (palettized && BuildPalette(images, TEXTURE_COUNT, &palette)) {
+        BuildColormaps(&colormaps, &palette, &shades);
+        for (int i = 0; i < TEXTURE_COUNT; i++) {
+            indexedImages[i] = QuantizeImage(images[i], &palette);
+            if (indexedImages[i].indices == NULL) return false;
+
+            textures[i] = MakeIndexedSoftTexture(&indexedImages[i], &colormaps);
+        }
+        return true;
+    }
+
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        textures[i] = LoadSoftTexture(images[i], i == TEXTURE_WALL);
+        if (textures[i].memory == NULL) return false;
+    }
+    return true;
+}
+
+// Bytes the textures in use take: texels or indices, mips and posts (not the colormaps the
+// palettized ones share)
+static size_t MeasureTextureMemory(void) {
+    size_t bytes = 0;
+    for (int i = 0; i < TEXTURE_COUNT; i++) bytes += GetSoftTextureMemory(&textures[i]);
+    return bytes;
+}
+
+// Bytes the same images take as RGBA textures, to compare the palettized ones with (0 if
+// there is no memory)
+static size_t MeasureRGBAMemory(const Image *const *images) {
+    size_t bytes = 0;
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        SoftTexture texture = LoadSoftTexture(images[i], i == TEXTURE_WALL);
+        if (texture.memory == NULL) return 0;
+
+        bytes += GetSoftTextureMemory(&texture);
+        UnloadSoftTexture(&texture);
+    }
+    return bytes;
+}
+
+// Point the images at the game's textures in the open asset archive, returns false if one of
+// them is missing
+static bool MapPackImages(const Image **images) {
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        const PackEntry *entry = FindPackEntry(textureAssets[i]);
+        if (entry == NULL || entry->type != PACK_ENTRY_IMAGE || entry->format != PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) {
+            printf("No %s in the asset archive\n", textureAssets[i]);
+            return false;
+        }
+
+        packImages[i] = (Image){ (void *)GetPackEntryData(entry), (int)entry->width, (int)entry->height, 1, entry->format };
+        images[i] = &packImages[i];
+    }
+    return true;
+}
+
+// Hand the renderer the palette and indices stored in the open asset archive by mkpack
+// --palette (used in place), returns false if the archive has none
+static bool PreparePackTextures(void) {
+    if (!LoadPackPalette(&palette)) {
+        printf("No palette in the asset archive (build it with mkpack --palette)\n");
+        return false;
+    }
+    BuildColormaps(&colormaps, &palette, &shades);
+
+    packIndices = true;
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        indexedImages[i] = GetPackIndexedImage(textureAssets[i]);
+        if (indexedImages[i].indices == NULL) {
+            printf("No palette indices of %s in the asset archive\n", textureAssets[i]);
+            return false;
+        }
+
+        textures[i] = MakeIndexedSoftTexture(&indexedImages[i], &colormaps);
+    }
+    return true;
+}
+
+// Sprites of the level: keys, enemies at their spawn cells and the exit door
+static void PlaceSprites(void) {
+    spriteCount = 0;
+
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH && spriteCount < MAX_RENDER_SPRITES; x++) {
+            const SoftTexture *texture = NULL;
+            if (maze.grid[y][x] == CELL_KEY) texture = &textures[TEXTURE_KEY];
+            else if (maze.grid[y][x] == CELL_ENEMY) texture = &textures[TEXTURE_ENEMY];
+            else if (maze.grid[y][x] == CELL_EXIT) texture = &textures[TEXTURE_DOOR];
+            if (texture == NULL) continue;
+
+            sprites[spriteCount].position = GridToWorld(x, y);
+            sprites[spriteCount].type = (CellType)maze.grid[y][x];
+            sprites[spriteCount].texture = *texture;
+            sprites[spriteCount].light = maze.light[y][x];
+            spriteOrder[spriteCount] = spriteCount;
+            spriteCount++;
+        }
+    }
+}
+
+// Shortest path of cells from the exit to the start (breadth-first search)
+static void FindPath(void) {
+    int previous[MAZE_HEIGHT][MAZE_WIDTH];
+    int queue[MAX_PATH_CELLS];
+    int head = 0;
+    int tail = 0;
+
+    for (int y = 0; y < MAZE_HEIGHT; y++) {
+        for (int x = 0; x < MAZE_WIDTH; x++) previous[y][x] = -2;
+    }
+
+    int start = (int)maze.startPos.y * MAZE_WIDTH + (int)maze.startPos.x;
+    int goal = (int)maze.exitPos.y * MAZE_WIDTH + (int)maze.exitPos.x;
+    previous[start / MAZE_WIDTH][start % MAZE_WIDTH] = -1;
+    queue[tail++] = start;
+
+    const int offsets[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+    while (head < tail) {
+        int cell = queue[head++];
+        if (cell == goal) break;
+
+        for (int d = 0; d < 4; d++) {
+            int nx = cell % MAZE_WIDTH + offsets[d][0];
+            int ny = cell / MAZE_WIDTH + offsets[d][1];
+            if (!IsCellWalkable(&maze, nx, ny) || previous[ny][nx] != -2) continue;
+
+            previous[ny][nx] = cell;
+            queue[tail++] = ny * MAZE_WIDTH + nx;
+        }
+    }
+
+    // Walk back from the exit: the script starts at the door, where most sprites are seen
+    pathLength = 0;
+    for (int cell = goal; cell >= 0; cell = previous[cell / MAZE_WIDTH][cell % MAZE_WIDTH]) {
+        pathCells[pathLength++] = GridToWorld(cell % MAZE_WIDTH, cell / MAZE_WIDTH);
+    }
+}
+
+// Camera of a frame of the script (the path is walked back and forth)
+static SoftCamera ScriptedCamera(int frame) {
+    int segmentFrames = TURN_FRAMES + MOVE_FRAMES;
+    int legs = (pathLength > 1) ? pathLength - 1 : 1;
+    float angle = 0.0f;
+
+    // Position in the script: every leg turns, walks and sometimes looks around
+    int legFrames = segmentFrames + LOOK_AROUND_FRAMES / LOOK_AROUND_CELLS;
+    int cycle = frame / (legFrames * legs);
+    int local = frame % (legFrames * legs);
+    int leg = local / legFrames;
+    int step = local % legFrames;
+    bool backwards = (cycle % 2) == 1;
+
+    int fromIndex = backwards ? pathLength - 1 - leg : leg;
+    int toIndex = backwards ? fromIndex - 1 : fromIndex + 1;
+    if (toIndex < 0 || toIndex >= pathLength) toIndex = fromIndex;
+
+    Vector2 from = pathCells[fromIndex];
+    Vector2 to = pathCells[toIndex];
+    float targetAngle = (float)atan2(to.y - from.y, to.x - from.x);
+
+    // Previous leg direction, to turn from
+    int prevIndex = backwards ? fromIndex + 1 : fromIndex - 1;
+    float startAngle = targetAngle;
+    if (prevIndex >= 0 && prevIndex < pathLength) {
+        startAngle = (float)atan2(from.y - pathCells[prevIndex].y, from.x - pathCells[prevIndex].x);
+    }
+    float turn = targetAngle - startAngle;
+    if (turn > PI) turn -= 2.0f * PI;
+    if (turn < -PI) turn += 2.0f * PI;
+
+    Vector2 position = from;
+    if (step < TURN_FRAMES) {
+        angle = startAngle + turn * (float)(step + 1) / TURN_FRAMES;
+    } else if (step < segmentFrames) {
+        angle = targetAngle;
+        position = LerpVector2(from, to, (float)(step - TURN_FRAMES + 1) / MOVE_FRAMES);
+    } else {
+        // Look around at the arrival cell, spread over the legs
+        int lookStep = (leg % LOOK_AROUND_CELLS) * (LOOK_AROUND_FRAMES / LOOK_AROUND_CELLS) + (step - segmentFrames);
+        angle = targetAngle + 2.0f * PI * (float)(lookStep + 1) / LOOK_AROUND_FRAMES;
+        position = to;
+    }
+
+    // Slightly off-center so the camera never sits exactly on cell lines
+    position.x += 0.07f;
+    position.y -= 0.05f;
+
+    return MakeSoftCamera(position, angle, FOV);
+}
+
+// Load the goldens file (missing file means no goldens)
+static void LoadGoldens(const char *fileName) {
+    FILE *file = fopen(fileName, "r");
+    if (file == NULL) return;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL && goldenCount < MAX_GOLDENS) {
+        Golden golden;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%dx%d %d %llx", &golden.width, &golden.height, &golden.frame, &golden.hash) == 4) {
+            goldens[goldenCount++] = golden;
+        }
+    }
+
+    fclose(file);
+}
+
+// Stored hash of a frame, returns false if there is none
+static bool FindGolden(int width, int height, int frame, unsigned long long *hash) {
+    for (int i = 0; i < goldenCount; i++) {
+        if (goldens[i].width == width && goldens[i].height == height && goldens[i].frame == frame) {
+            *hash = goldens[i].hash;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Replace the goldens of one resolution and write the file
+static bool SaveGoldens(const char *fileName, int width, int height, const unsigned long long *hashes, int frames) {
+    int kept = 0;
+    for (int i = 0; i < goldenCount; i++) {
+        if (goldens[i].width != width || goldens[i].height != height) goldens[kept++] = goldens[i];
+    }
+    goldenCount = kept;
+
+    for (int i = 0; i < frames && goldenCount < MAX_GOLDENS; i++) {
+        goldens[goldenCount++] = (Golden){ width, height, i, hashes[i] };
+    }
+
+    FILE *file = fopen(fileName, "w");
+    if (file == NULL) return false;
+
+    fprintf(file, "# MazeRay render goldens (tools/renderbench.c), seed %u\n", RENDER_SEED);
+    fprintf(file, "# resolution frame fnv1a64\n");
+    for (int i = 0; i < goldenCount; i++) {
+        fprintf(file, "%dx%d %d %016llx\n", goldens[i].width, goldens[i].height, goldens[i].frame, goldens[i].hash);
+    }
+
+    return fclose(file) == 0;
+}
+
+// ----------------------------------------------------------------------------------
+// Main
+// ----------------------------------------------------------------------------------
+int main(int argc, char *argv[]) {
+    int width = DEFAULT_WIDTH;
+    int height = DEFAULT_HEIGHT;
+    int frames = DEFAULT_FRAMES;
+    const char *ppmDir = NULL;
+    const char *goldensFile = NULL;
+    const char *packFile = NULL;
+    bool updateGoldens = false;
+    bool palettized = false;
+    CastMode castMode = CAST_CACHED;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) {
+            ppmDir = argv[++i];
+        } else if (strcmp(argv[i], "--goldens") == 0 && i + 1 < argc) {
+            goldensFile = argv[++i];
+        } else if (strcmp(argv[i], "--update-goldens") == 0) {
+            updateGoldens = true;
+        } else if (strcmp(argv[i], "--palette") == 0) {
+            palettized = true;
+        } else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            packFile = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--cast") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "dda") == 0) castMode = CAST_DDA;
+            else if (strcmp(argv[i], "coherent") == 0) castMode = CAST_COHERENT;
+            else castMode = CAST_CACHED;
+        } else {
+            printf("Usage: %s [--width W] [--height H] [--frames N] [--ppm dir] [--goldens file] [--update-goldens] "
+                   "[--cast dda|coherent|cached] [--threads N] [--palette] [--pack file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (width < 2 || height < 2 || frames < 1) {
+        printf("Invalid resolution or frame count\n");
+        return 1;
+    }
+
+    // The goldens are those of the procedural textures
+    bool checkGoldens = (packFile == NULL || goldensFile != NULL);
+    if (goldensFile == NULL) goldensFile = palettized ? PALETTE_GOLDENS : DEFAULT_GOLDENS;
+    if (threads > 0) threads = StartWorkers(threads);
+
+    GenerateMaze(&maze, RENDER_SEED);
+    if (maze.light[(int)maze.startPos.y][(int)maze.startPos.x] != LIGHT_LEVELS - 1) {
+        printf("Start cell isn't lit\n");
+        return 1;
+    }
+    BuildShadeTable(&shades, FOG_START, FOG_END);
+    GenerateTextures();
+
+    const Image *images[TEXTURE_COUNT] = { &wallImage, &keyImage, &enemyImage, &doorImage };
+    bool texturesReady = false;
+    if (packFile == NULL) {
+        texturesReady = PrepareTextures(images, palettized);
+        if (!texturesReady) printf("Out of memory\n");
+    } else if (!OpenAssetPack(packFile)) {
+        printf("Could not open %s\n", packFile);
+    } else if (MapPackImages(images)) {
+        texturesReady = palettized ? PreparePackTextures() : PrepareTextures(images, false);
+        if (!texturesReady && !palettized) printf("Out of memory\n");
+    }
+    if (!texturesReady) return 1;
+
+    PlaceSprites();
+    FindPath();
+    if (checkGoldens) LoadGoldens(goldensFile);
+
+    SoftFrame frame = LoadSoftFrame(width, height);
+    ColumnBuffer columns = { 0 };
+    double *times = (double *)malloc(frames * sizeof(double));
+    unsigned long long *hashes = (unsigned long long *)malloc(frames * sizeof(unsigned long long));
+    if (frame.pixels == NULL || times == NULL || hashes == NULL) {
+        printf("Out of memory\n");
+        return 1;
+    }
+
+    int mismatches = 0;
+    int missing = 0;
+    double total = 0.0;
+
+    for (int i = 0; i < frames; i++) {
+        SoftCamera camera = ScriptedCamera(i);
+
+        double start = ReadClock();
+        SoftRenderFloor(&frame, &maze, &camera, &floorImage, &ceilingImage, &shades);
+        if (!SoftRenderWalls(&frame, &columns, &maze, &camera, &textures[TEXTURE_WALL], MAX_DISTANCE, castMode, &shades)) {
+            printf("Out of memory\n");
+            return 1;
+        }
+        SoftRenderSprites(&frame, columns.depth, sprites, spriteCount, spriteOrder, &camera, &shades);
+        times[i] = ReadClock() - start;
+        total += times[i];
+
+        hashes[i] = HashSoftFrame(&frame);
+
+        unsigned long long expected;
+        if (!FindGolden(width, height, i, &expected)) {
+            missing++;
+        } else if (expected != hashes[i] && !updateGoldens) {
+            printf("Frame %d: hash %016llx, golden %016llx\n", i, hashes[i], expected);
+            mismatches++;
+        }
+
+        if (ppmDir != NULL) {
+            char fileName[512];
+            snprintf(fileName, sizeof(fileName), "%s/frame_%04d.ppm", ppmDir, i);
+            if (!ExportSoftFramePPM(&frame, fileName)) {
+                printf("Could not write %s\n", fileName);
+                return 1;
+            }
+        }
+    }
+
+    qsort(times, frames, sizeof(double), CompareDoubles);
+    double median = (frames % 2) ? times[frames/2] : 0.5 * (times[frames/2 - 1] + times[frames/2]);
+
+    printf("Rendered %d frames at %dx%d (%d worker threads)\n", frames, width, height, (threads > 0) ? threads : 0);
+    printf("ms/frame: mean %.3f, median %.3f, min %.3f, max %.3f\n", total / frames, median, times[0], times[frames - 1]);
+    int posts = 0;
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        if (textures[i].posts != NULL) posts += textures[i].columnPosts[textures[i].width];
+    }
+    size_t textureMemory = MeasureTextureMemory();
+    if (palettized) {
+        printf("Texture memory: %zu bytes (%zu of indices and posts, %zu of colormaps for %d palette colors), "
+               "%zu as RGBA, %d sprite posts\n", textureMemory + sizeof(Colormaps), textureMemory, sizeof(Colormaps),
+               palette.count, MeasureRGBAMemory(images), posts);
+    } else {
+        printf("Texture memory: %zu bytes (RGBA texels, wall mips and posts), %d sprite posts\n", textureMemory, posts);
+    }
+
+    int result = 0;
+    if (!checkGoldens) {
+        printf("Goldens not checked (textures of %s, pass --goldens to check them)\n", packFile);
+    } else if (updateGoldens) {
+        if (SaveGoldens(goldensFile, width, height, hashes, frames)) {
+            printf("Goldens updated: %s\n", goldensFile);
+        } else {
+            printf("Could not write %s\n", goldensFile);
+            result = 1;
+        }
+    } else if (mismatches > 0 || missing > 0) {
+        if (mismatches > 0) printf("FAILED: %d of %d frames differ from the goldens\n", mismatches, frames);
+        if (missing > 0) {
+            printf("FAILED: %d of %d frames have no golden for %dx%d in %s (run with --update-goldens)\n",
+                   missing, frames, width, height, goldensFile);
+        }
+        result = 1;
+    } else {
+        printf("Goldens OK (%d frames checked)\n", frames);
+    }
+
+    free(hashes);
+    free(times);
+    FreeColumnBuffer(&columns);
+    UnloadSoftFrame(&frame);
+    StopWorkers();
+    free(wallImage.data);
+    free(floorImage.data);
+    free(ceilingImage.data);
+    free(keyImage.data);
+    free(enemyImage.data);
+    free(doorImage.data);
+    for (int i = 0; i < TEXTURE_COUNT; i++) {
+        if (indexedImages[i].indices != NULL && !packIndices) UnloadIndexedImage(&indexedImages[i]);
+        UnloadSoftTexture(&textures[i]);
+    }
+    CloseAssetPack();
+
+    return result;
+}